@@ -0,0 +1,247 @@
+#include "benchmark.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "document_filters.h"
+#include "log_duration.h"
+#include "ratings.h"
+#include "search_server.h"
+
+static std::string GenerateWord(std::mt19937& generator, int max_length) {
+    const int length = std::uniform_int_distribution(1, max_length)(generator);
+    std::string word;
+    word.reserve(length);
+    for (int i = 0; i < length; ++i) {
+        word.push_back(static_cast<char>(std::uniform_int_distribution('a' + 0, 'z' + 0)(generator)));
+    }
+    return word;
+}
+
+static std::vector<std::string> GenerateDictionary(std::mt19937& generator, int word_count, int max_length) {
+    std::vector<std::string> words;
+    words.reserve(word_count);
+    for (int i = 0; i < word_count; ++i) {
+        words.push_back(GenerateWord(generator, max_length));
+    }
+    std::sort(words.begin(), words.end());
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+    return words;
+}
+
+static std::string GenerateQuery(std::mt19937& generator, const std::vector<std::string>& dictionary,
+    int word_count, double minus_prob = 0) {
+    std::string query;
+    for (int i = 0; i < word_count; ++i) {
+        if (!query.empty()) {
+            query.push_back(' ');
+        }
+        if (std::uniform_real_distribution<>(0, 1)(generator) < minus_prob) {
+            query.push_back('-');
+        }
+        query += dictionary[std::uniform_int_distribution<int>(0, dictionary.size() - 1)(generator)];
+    }
+    return query;
+}
+
+static std::vector<std::string> GenerateQueries(std::mt19937& generator, const std::vector<std::string>& dictionary,
+    int query_count, int max_word_count) {
+    std::vector<std::string> queries;
+    queries.reserve(query_count);
+    for (int i = 0; i < query_count; ++i) {
+        queries.push_back(GenerateQuery(generator, dictionary, max_word_count, 0.1));
+    }
+    return queries;
+}
+
+template <typename ExecutionPolicy, typename Filter, typename Scorer = TfIdfScorer>
+static void RunFindTopDocuments(const std::string& mark, const SearchServer& search_server,
+    const std::vector<std::string>& queries, ExecutionPolicy&& policy, Filter filter, std::ostream& out,
+    const Scorer& scorer = {}) {
+    size_t found_count = 0;
+    {
+        LOG_DURATION_STREAM(mark, out);
+        for (const std::string& query : queries) {
+            found_count += search_server.FindTopDocuments(policy, query, filter, scorer).size();
+        }
+    }
+    out << "  found: "s << found_count << std::endl;
+}
+
+static SearchServer GenerateSearchServer(std::mt19937& generator, const std::vector<std::string>& dictionary,
+    int document_count, int max_word_count) {
+    SearchServer search_server(dictionary[0]);
+    for (int i = 0; i < document_count; ++i) {
+        search_server.AddDocument(i, GenerateQuery(generator, dictionary, max_word_count),
+            static_cast<DocumentStatus>(i % 4), { i % 11, i % 7 });
+    }
+    return search_server;
+}
+
+// Сравнивает фильтры-политики с эквивалентными им произвольными предикатами
+void BenchmarkFilterKernels(std::ostream& out) {
+    std::mt19937 generator;
+    const std::vector<std::string> dictionary = GenerateDictionary(generator, 2'000, 10);
+    const std::vector<std::string> queries = GenerateQueries(generator, dictionary, 500, 7);
+
+    const SearchServer search_server = GenerateSearchServer(generator, dictionary, 20'000, 70);
+
+    RunFindTopDocuments("No filter, predicate"s, search_server, queries, std::execution::seq,
+        [](int, DocumentStatus, int) { return true; }, out);
+    RunFindTopDocuments("No filter, NoFilter"s, search_server, queries, std::execution::seq,
+        NoFilter{}, out);
+
+    RunFindTopDocuments("Status, predicate"s, search_server, queries, std::execution::seq,
+        [](int, DocumentStatus status, int) { return status == DocumentStatus::ACTUAL; }, out);
+    RunFindTopDocuments("Status, DocumentFilter"s, search_server, queries, std::execution::seq,
+        DocumentFilter{ DocumentStatus::ACTUAL }, out);
+
+    RunFindTopDocuments("Rating, predicate"s, search_server, queries, std::execution::seq,
+        [](int, DocumentStatus, int rating) { return rating >= 5; }, out);
+    RunFindTopDocuments("Rating, DocumentFilter"s, search_server, queries, std::execution::seq,
+        DocumentFilter{ std::nullopt, 5 }, out);
+
+    RunFindTopDocuments("Status, predicate, par"s, search_server, queries, std::execution::par,
+        [](int, DocumentStatus status, int) { return status == DocumentStatus::ACTUAL; }, out);
+    RunFindTopDocuments("Status, DocumentFilter, par"s, search_server, queries, std::execution::par,
+        DocumentFilter{ DocumentStatus::ACTUAL }, out);
+
+    // Редкий статус: DocumentFilter отбрасывает документы по битовой карте до оценки,
+    // а предикату для каждого кандидата нужны данные документа
+    SearchServer selective_server(dictionary[0]);
+    for (int i = 0; i < 100'000; ++i) {
+        selective_server.AddDocument(i, GenerateQuery(generator, dictionary, 20),
+            i % 64 == 0 ? DocumentStatus::BANNED : DocumentStatus::ACTUAL, { i % 11 });
+    }
+    RunFindTopDocuments("Rare status, predicate"s, selective_server, queries, std::execution::seq,
+        [](int, DocumentStatus status, int) { return status == DocumentStatus::BANNED; }, out);
+    RunFindTopDocuments("Rare status, DocumentFilter"s, selective_server, queries, std::execution::seq,
+        DocumentFilter{ DocumentStatus::BANNED }, out);
+}
+
+// Рейтинги разбросаны по ±50000, поэтому почти у каждого документа свой рейтинг
+void BenchmarkRatingFilters(std::ostream& out) {
+    std::mt19937 generator;
+    const std::vector<std::string> dictionary = GenerateDictionary(generator, 2'000, 10);
+    const std::vector<std::string> queries = GenerateQueries(generator, dictionary, 200, 1);
+
+    SearchServer search_server(dictionary[0]);
+    std::uniform_int_distribution<int> rating_distribution(-50'000, 50'000);
+    for (int i = 0; i < 100'000; ++i) {
+        search_server.AddDocument(i, GenerateQuery(generator, dictionary, 20),
+            static_cast<DocumentStatus>(i % 4), { rating_distribution(generator) });
+    }
+
+    RunFindTopDocuments("Rating >= 0, predicate"s, search_server, queries, std::execution::seq,
+        [](int, DocumentStatus, int rating) { return rating >= 0; }, out);
+    RunFindTopDocuments("Rating >= 0, DocumentFilter"s, search_server, queries, std::execution::seq,
+        DocumentFilter{ std::nullopt, 0 }, out);
+    RunFindTopDocuments("Status and rating range, predicate"s, search_server, queries, std::execution::seq,
+        [](int, DocumentStatus status, int rating) {
+            return status == DocumentStatus::ACTUAL && rating >= -10'000 && rating <= 10'000;
+        }, out);
+    RunFindTopDocuments("Status and rating range, DocumentFilter"s, search_server, queries, std::execution::seq,
+        DocumentFilter{ DocumentStatus::ACTUAL, -10'000, 10'000 }, out);
+
+    // Длинные запросы просматривают много вхождений, для них фильтр строит карту по срезам рейтингов
+    const std::vector<std::string> long_queries = GenerateQueries(generator, dictionary, 50, 30);
+    RunFindTopDocuments("Long queries, rating range, predicate"s, search_server, long_queries, std::execution::seq,
+        [](int, DocumentStatus, int rating) { return rating >= -10'000 && rating <= 10'000; }, out);
+    RunFindTopDocuments("Long queries, rating range, DocumentFilter"s, search_server, long_queries,
+        std::execution::seq, DocumentFilter{ std::nullopt, -10'000, 10'000 }, out);
+}
+
+// BM25 считается в float по блокам вхождений, TF-IDF - в double
+void BenchmarkScorers(std::ostream& out) {
+    std::mt19937 generator;
+    const std::vector<std::string> dictionary = GenerateDictionary(generator, 2'000, 10);
+    const std::vector<std::string> queries = GenerateQueries(generator, dictionary, 500, 7);
+    const SearchServer search_server = GenerateSearchServer(generator, dictionary, 20'000, 70);
+
+    RunFindTopDocuments("TF-IDF"s, search_server, queries, std::execution::seq, NoFilter{}, out, TfIdfScorer{});
+    RunFindTopDocuments("BM25"s, search_server, queries, std::execution::seq, NoFilter{}, out, Bm25Scorer{});
+    RunFindTopDocuments("TF-IDF, par"s, search_server, queries, std::execution::par, NoFilter{}, out, TfIdfScorer{});
+    RunFindTopDocuments("BM25, par"s, search_server, queries, std::execution::par, NoFilter{}, out, Bm25Scorer{});
+}
+
+// Показывает, какие стратегии выбирает планировщик для запросов разной длины
+void ReportQueryPlans(std::ostream& out) {
+    std::mt19937 generator;
+    const std::vector<std::string> dictionary = GenerateDictionary(generator, 2'000, 10);
+    const SearchServer search_server = GenerateSearchServer(generator, dictionary, 20'000, 70);
+
+    for (const int max_word_count : { 3, 7, 30 }) {
+        std::map<QueryStrategy, int> strategy_counts;
+        int parallel_count = 0;
+        for (const std::string& query : GenerateQueries(generator, dictionary, 500, max_word_count)) {
+            const QueryPlan plan = search_server.Explain(std::execution::par, query);
+            ++strategy_counts[plan.strategy];
+            parallel_count += plan.is_parallel;
+        }
+        out << "Up to "s << max_word_count << " words:"s;
+        for (const auto [strategy, count] : strategy_counts) {
+            out << " "s << strategy << " = "s << count;
+        }
+        out << ", parallel = "s << parallel_count << std::endl;
+    }
+    out << search_server.Explain(std::execution::par, dictionary[0] + " "s + dictionary[1] + " -"s + dictionary[2]);
+}
+
+// Сравнивает блочную 64-битную агрегацию рейтингов с прежним скалярным циклом по int
+void BenchmarkRatingStats(std::ostream& out) {
+    std::mt19937 generator;
+    std::uniform_int_distribution<int> rating_distribution(1, 100);
+    std::vector<std::vector<int>> documents_ratings(2'000);
+    for (std::vector<int>& ratings : documents_ratings) {
+        ratings.resize(5'000);
+        for (int& rating : ratings) {
+            rating = rating_distribution(generator);
+        }
+    }
+
+    long long checksum = 0;
+    {
+        LOG_DURATION_STREAM("Scalar int average"s, out);
+        for (const std::vector<int>& ratings : documents_ratings) {
+            int rating_sum = 0;
+            for (const int rating : ratings) {
+                rating_sum += rating;
+            }
+            checksum += rating_sum / static_cast<int>(ratings.size());
+        }
+    }
+    out << "  checksum: "s << checksum << std::endl;
+
+    checksum = 0;
+    {
+        LOG_DURATION_STREAM("ComputeRatingStats"s, out);
+        for (const std::vector<int>& ratings : documents_ratings) {
+            const RatingStats stats = ComputeRatingStats(ratings);
+            checksum += stats.mean;
+        }
+    }
+    out << "  checksum: "s << checksum << std::endl;
+}
+
+// Сравнивает прямой индекс с прежним std::map<int, std::map<std::string_view, double>>,
+// объём которого оценивается по размеру узлов дерева
+void ReportForwardIndexMemory(std::ostream& out) {
+    std::mt19937 generator;
+    const std::vector<std::string> dictionary = GenerateDictionary(generator, 20'000, 10);
+    const int document_count = 100'000;
+    const SearchServer search_server = GenerateSearchServer(generator, dictionary, document_count, 70);
+
+    const size_t map_node_overhead = 4 * sizeof(void*);
+    const SearchServer::MemoryReport report = search_server.GetMemoryReport();
+    const size_t map_memory = report.forward_index_entries
+        * (sizeof(std::pair<const std::string_view, double>) + map_node_overhead)
+        + document_count * (sizeof(std::pair<const int, std::map<std::string_view, double>>) + map_node_overhead);
+
+    out << "Documents: "s << document_count << ", word entries: "s << report.forward_index_entries << std::endl;
+    out << "std::map forward index (estimate): "s << map_memory / 1024 << " KiB"s << std::endl;
+    out << "ForwardIndex: "s << report.forward_index / 1024 << " KiB"s << std::endl;
+}
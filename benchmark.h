@@ -0,0 +1,9 @@
+#pragma once
+#include <iostream>
+
+void BenchmarkFilterKernels(std::ostream& out = std::cout);
+void BenchmarkRatingFilters(std::ostream& out = std::cout);
+void BenchmarkScorers(std::ostream& out = std::cout);
+void ReportQueryPlans(std::ostream& out = std::cout);
+void BenchmarkRatingStats(std::ostream& out = std::cout);
+void ReportForwardIndexMemory(std::ostream& out = std::cout);
@@ -0,0 +1,285 @@
+#include "bitmap.h"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+void Bitmap::Add(uint32_t value) {
+    const uint16_t key = static_cast<uint16_t>(value >> 16);
+    const uint16_t low = static_cast<uint16_t>(value & 0xFFFF);
+    auto container_it = FindContainer(key);
+    if (container_it == containers_.end() || container_it->key != key) {
+        Container container;
+        container.key = key;
+        container_it = containers_.insert(container_it, std::move(container));
+    }
+
+    Container& container = *container_it;
+    if (!container.bits.empty()) {
+        uint64_t& word = container.bits[low / 64];
+        const uint64_t mask = uint64_t{ 1 } << (low % 64);
+        container.size += (word & mask) == 0;
+        word |= mask;
+        return;
+    }
+
+    const auto value_it = std::lower_bound(container.values.begin(), container.values.end(), low);
+    if (value_it != container.values.end() && *value_it == low) {
+        return;
+    }
+    container.values.insert(value_it, low);
+    ++container.size;
+    Normalize(container);
+}
+
+void Bitmap::Remove(uint32_t value) {
+    const uint16_t key = static_cast<uint16_t>(value >> 16);
+    const uint16_t low = static_cast<uint16_t>(value & 0xFFFF);
+    const auto container_it = FindContainer(key);
+    if (container_it == containers_.end() || container_it->key != key) {
+        return;
+    }
+
+    Container& container = *container_it;
+    if (!container.bits.empty()) {
+        uint64_t& word = container.bits[low / 64];
+        const uint64_t mask = uint64_t{ 1 } << (low % 64);
+        container.size -= (word & mask) != 0;
+        word &= ~mask;
+    }
+    else {
+        const auto value_it = std::lower_bound(container.values.begin(), container.values.end(), low);
+        if (value_it == container.values.end() || *value_it != low) {
+            return;
+        }
+        container.values.erase(value_it);
+        --container.size;
+    }
+
+    if (container.size == 0) {
+        containers_.erase(container_it);
+    }
+    else {
+        Normalize(container);
+    }
+}
+
+bool Bitmap::Contains(uint32_t value) const {
+    const uint16_t key = static_cast<uint16_t>(value >> 16);
+    const auto container_it = FindContainer(key);
+    return container_it != containers_.end() && container_it->key == key
+        && Contains(*container_it, static_cast<uint16_t>(value & 0xFFFF));
+}
+
+bool Bitmap::IsEmpty() const {
+    return containers_.empty();
+}
+
+size_t Bitmap::GetSize() const {
+    size_t size = 0;
+    for (const Container& container : containers_) {
+        size += container.size;
+    }
+    return size;
+}
+
+size_t Bitmap::GetMemoryUsage() const {
+    size_t memory = containers_.capacity() * sizeof(Container);
+    for (const Container& container : containers_) {
+        memory += container.values.capacity() * sizeof(uint16_t) + container.bits.capacity() * sizeof(uint64_t);
+    }
+    return memory;
+}
+
+Bitmap& Bitmap::operator|=(const Bitmap& other) {
+    std::vector<Container> result;
+    result.reserve(containers_.size() + other.containers_.size());
+    auto lhs = containers_.begin();
+    auto rhs = other.containers_.begin();
+    while (lhs != containers_.end() || rhs != other.containers_.end()) {
+        if (rhs == other.containers_.end() || (lhs != containers_.end() && lhs->key < rhs->key)) {
+            result.push_back(std::move(*lhs++));
+        }
+        else if (lhs == containers_.end() || rhs->key < lhs->key) {
+            result.push_back(*rhs++);
+        }
+        else {
+            Unite(*lhs, *rhs++);
+            result.push_back(std::move(*lhs++));
+        }
+    }
+    containers_ = std::move(result);
+    return *this;
+}
+
+Bitmap& Bitmap::operator&=(const Bitmap& other) {
+    std::vector<Container> result;
+    auto rhs = other.containers_.begin();
+    for (Container& container : containers_) {
+        while (rhs != other.containers_.end() && rhs->key < container.key) {
+            ++rhs;
+        }
+        if (rhs == other.containers_.end()) {
+            break;
+        }
+        if (rhs->key == container.key) {
+            Intersect(container, *rhs);
+            if (container.size > 0) {
+                result.push_back(std::move(container));
+            }
+        }
+    }
+    containers_ = std::move(result);
+    return *this;
+}
+
+Bitmap& Bitmap::operator-=(const Bitmap& other) {
+    std::vector<Container> result;
+    result.reserve(containers_.size());
+    auto rhs = other.containers_.begin();
+    for (Container& container : containers_) {
+        while (rhs != other.containers_.end() && rhs->key < container.key) {
+            ++rhs;
+        }
+        if (rhs != other.containers_.end() && rhs->key == container.key) {
+            Subtract(container, *rhs);
+        }
+        if (container.size > 0) {
+            result.push_back(std::move(container));
+        }
+    }
+    containers_ = std::move(result);
+    return *this;
+}
+
+void Bitmap::ToBits(Container& container) {
+    if (!container.bits.empty()) {
+        return;
+    }
+    container.bits.assign(BITS_WORD_COUNT, 0);
+    for (const uint16_t value : container.values) {
+        container.bits[value / 64] |= uint64_t{ 1 } << (value % 64);
+    }
+    container.values.clear();
+    container.values.shrink_to_fit();
+}
+
+// Массив становится битовой картой, когда начинает занимать больше неё, и наоборот
+void Bitmap::Normalize(Container& container) {
+    if (container.bits.empty() && container.size > MAX_ARRAY_SIZE) {
+        ToBits(container);
+    }
+    else if (!container.bits.empty() && container.size <= MAX_ARRAY_SIZE) {
+        container.values.reserve(container.size);
+        for (size_t word = 0; word < BITS_WORD_COUNT; ++word) {
+            for (uint64_t bits = container.bits[word]; bits != 0; bits &= bits - 1) {
+                container.values.push_back(static_cast<uint16_t>(word * 64 + __builtin_ctzll(bits)));
+            }
+        }
+        container.bits.clear();
+        container.bits.shrink_to_fit();
+    }
+}
+
+bool Bitmap::Contains(const Container& container, uint16_t value) {
+    if (!container.bits.empty()) {
+        return (container.bits[value / 64] >> (value % 64)) & 1;
+    }
+    return std::binary_search(container.values.begin(), container.values.end(), value);
+}
+
+void Bitmap::Unite(Container& lhs, const Container& rhs) {
+    if (lhs.bits.empty() && rhs.bits.empty()) {
+        std::vector<uint16_t> values;
+        values.reserve(lhs.values.size() + rhs.values.size());
+        std::set_union(lhs.values.begin(), lhs.values.end(), rhs.values.begin(), rhs.values.end(),
+            std::back_inserter(values));
+        lhs.values = std::move(values);
+        lhs.size = lhs.values.size();
+        Normalize(lhs);
+        return;
+    }
+
+    ToBits(lhs);
+    lhs.size = 0;
+    if (!rhs.bits.empty()) {
+        for (size_t word = 0; word < BITS_WORD_COUNT; ++word) {
+            lhs.bits[word] |= rhs.bits[word];
+        }
+    }
+    for (const uint16_t value : rhs.values) {
+        lhs.bits[value / 64] |= uint64_t{ 1 } << (value % 64);
+    }
+    for (const uint64_t bits : lhs.bits) {
+        lhs.size += __builtin_popcountll(bits);
+    }
+}
+
+void Bitmap::Intersect(Container& lhs, const Container& rhs) {
+    if (!lhs.bits.empty() && !rhs.bits.empty()) {
+        lhs.size = 0;
+        for (size_t word = 0; word < BITS_WORD_COUNT; ++word) {
+            lhs.bits[word] &= rhs.bits[word];
+            lhs.size += __builtin_popcountll(lhs.bits[word]);
+        }
+    }
+    else if (lhs.bits.empty()) {
+        lhs.values.erase(std::remove_if(lhs.values.begin(), lhs.values.end(),
+            [&rhs](uint16_t value) {
+                return !Contains(rhs, value);
+            }), lhs.values.end());
+        lhs.size = lhs.values.size();
+    }
+    else {
+        std::vector<uint16_t> values;
+        for (const uint16_t value : rhs.values) {
+            if (Contains(lhs, value)) {
+                values.push_back(value);
+            }
+        }
+        lhs.bits.clear();
+        lhs.bits.shrink_to_fit();
+        lhs.values = std::move(values);
+        lhs.size = lhs.values.size();
+    }
+    Normalize(lhs);
+}
+
+void Bitmap::Subtract(Container& lhs, const Container& rhs) {
+    if (lhs.bits.empty()) {
+        lhs.values.erase(std::remove_if(lhs.values.begin(), lhs.values.end(),
+            [&rhs](uint16_t value) {
+                return Contains(rhs, value);
+            }), lhs.values.end());
+        lhs.size = lhs.values.size();
+        return;
+    }
+
+    if (!rhs.bits.empty()) {
+        for (size_t word = 0; word < BITS_WORD_COUNT; ++word) {
+            lhs.bits[word] &= ~rhs.bits[word];
+        }
+    }
+    for (const uint16_t value : rhs.values) {
+        lhs.bits[value / 64] &= ~(uint64_t{ 1 } << (value % 64));
+    }
+    lhs.size = 0;
+    for (const uint64_t bits : lhs.bits) {
+        lhs.size += __builtin_popcountll(bits);
+    }
+    Normalize(lhs);
+}
+
+std::vector<Bitmap::Container>::iterator Bitmap::FindContainer(uint16_t key) {
+    return std::lower_bound(containers_.begin(), containers_.end(), key,
+        [](const Container& container, uint16_t key) {
+            return container.key < key;
+        });
+}
+
+std::vector<Bitmap::Container>::const_iterator Bitmap::FindContainer(uint16_t key) const {
+    return std::lower_bound(containers_.begin(), containers_.end(), key,
+        [](const Container& container, uint16_t key) {
+            return container.key < key;
+        });
+}
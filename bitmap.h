@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Сжатое множество номеров документов в духе Roaring bitmap.
+// Числа группируются по старшим 16 битам; редкая группа хранится
+// отсортированным массивом, плотная - битовой картой на 65536 бит
+class Bitmap {
+public:
+    void Add(uint32_t value);
+    void Remove(uint32_t value);
+    bool Contains(uint32_t value) const;
+    bool IsEmpty() const;
+    size_t GetSize() const;
+    size_t GetMemoryUsage() const;
+
+    Bitmap& operator|=(const Bitmap& other);
+    Bitmap& operator&=(const Bitmap& other);
+    Bitmap& operator-=(const Bitmap& other);
+
+private:
+    struct Container {
+        uint16_t key = 0;
+        size_t size = 0;
+        std::vector<uint16_t> values;
+        std::vector<uint64_t> bits;
+    };
+
+private:
+    static const size_t MAX_ARRAY_SIZE = 4096;
+    static const size_t BITS_WORD_COUNT = 65536 / 64;
+
+private:
+    static void ToBits(Container& container);
+    static void Normalize(Container& container);
+    static bool Contains(const Container& container, uint16_t value);
+    static void Unite(Container& lhs, const Container& rhs);
+    static void Intersect(Container& lhs, const Container& rhs);
+    static void Subtract(Container& lhs, const Container& rhs);
+
+    std::vector<Container>::iterator FindContainer(uint16_t key);
+    std::vector<Container>::const_iterator FindContainer(uint16_t key) const;
+
+private:
+    std::vector<Container> containers_;
+};
@@ -0,0 +1,132 @@
+#include "block_compression.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+const size_t MIN_MATCH = 4;
+const size_t MAX_OFFSET = 65535;
+const int HASH_BITS = 12;
+
+static uint32_t ReadWord(const char* data) {
+    uint32_t word;
+    std::memcpy(&word, data, sizeof(word));
+    return word;
+}
+
+static size_t HashWord(uint32_t word) {
+    return (word * 2654435761u) >> (32 - HASH_BITS);
+}
+
+static void WriteLength(std::vector<char>& out, size_t length) {
+    for (; length >= 255; length -= 255) {
+        out.push_back(static_cast<char>(255));
+    }
+    out.push_back(static_cast<char>(length));
+}
+
+static void WriteSequence(std::vector<char>& out, std::string_view literals, size_t offset, size_t match_length) {
+    const size_t literal_length = literals.size();
+    const size_t match_code = match_length == 0 ? 0 : match_length - MIN_MATCH;
+    out.push_back(static_cast<char>((std::min<size_t>(literal_length, 15) << 4) | std::min<size_t>(match_code, 15)));
+    if (literal_length >= 15) {
+        WriteLength(out, literal_length - 15);
+    }
+    out.insert(out.end(), literals.begin(), literals.end());
+    if (match_length == 0) {
+        return;
+    }
+    out.push_back(static_cast<char>(offset & 0xFF));
+    out.push_back(static_cast<char>(offset >> 8));
+    if (match_code >= 15) {
+        WriteLength(out, match_code - 15);
+    }
+}
+
+std::vector<char> CompressBlock(std::string_view data) {
+    std::vector<char> out;
+    out.reserve(data.size() / 2 + 16);
+    std::vector<int> table(1 << HASH_BITS, -1);
+
+    size_t anchor = 0;
+    size_t pos = 0;
+    while (pos + MIN_MATCH <= data.size()) {
+        const uint32_t word = ReadWord(data.data() + pos);
+        int& candidate = table[HashWord(word)];
+        const size_t match_pos = candidate;
+        const bool found = candidate >= 0 && pos - match_pos <= MAX_OFFSET
+            && ReadWord(data.data() + match_pos) == word;
+        candidate = static_cast<int>(pos);
+        if (!found) {
+            ++pos;
+            continue;
+        }
+
+        size_t match_length = MIN_MATCH;
+        while (pos + match_length < data.size() && data[match_pos + match_length] == data[pos + match_length]) {
+            ++match_length;
+        }
+        WriteSequence(out, data.substr(anchor, pos - anchor), pos - match_pos, match_length);
+        pos += match_length;
+        anchor = pos;
+    }
+    WriteSequence(out, data.substr(anchor), 0, 0);
+    return out;
+}
+
+static size_t ReadLength(const std::vector<char>& in, size_t& pos, size_t length) {
+    if (length != 15) {
+        return length;
+    }
+    unsigned char byte = 255;
+    while (byte == 255) {
+        if (pos >= in.size()) {
+            using namespace std::string_literals;
+            throw std::runtime_error("Corrupted compressed block"s);
+        }
+        byte = static_cast<unsigned char>(in[pos++]);
+        length += byte;
+    }
+    return length;
+}
+
+std::string DecompressBlock(const std::vector<char>& compressed, size_t raw_size) {
+    using namespace std::string_literals;
+    std::string out;
+    out.reserve(raw_size);
+
+    size_t pos = 0;
+    while (pos < compressed.size()) {
+        const unsigned char token = static_cast<unsigned char>(compressed[pos++]);
+        const size_t literal_length = ReadLength(compressed, pos, token >> 4);
+        if (pos + literal_length > compressed.size()) {
+            throw std::runtime_error("Corrupted compressed block"s);
+        }
+        out.append(compressed.data() + pos, literal_length);
+        pos += literal_length;
+        if (pos == compressed.size()) {
+            break;
+        }
+
+        if (pos + 2 > compressed.size()) {
+            throw std::runtime_error("Corrupted compressed block"s);
+        }
+        const size_t offset = static_cast<unsigned char>(compressed[pos])
+            | (static_cast<size_t>(static_cast<unsigned char>(compressed[pos + 1])) << 8);
+        pos += 2;
+        const size_t match_length = ReadLength(compressed, pos, token & 0x0F) + MIN_MATCH;
+        if (offset == 0 || offset > out.size()) {
+            throw std::runtime_error("Corrupted compressed block"s);
+        }
+        // Совпадение может перекрываться с копируемым участком, поэтому копируем побайтово
+        for (size_t from = out.size() - offset, i = 0; i < match_length; ++i) {
+            out.push_back(out[from + i]);
+        }
+    }
+
+    if (out.size() != raw_size) {
+        throw std::runtime_error("Corrupted compressed block"s);
+    }
+    return out;
+}
@@ -0,0 +1,9 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Сжатие блока в формате, аналогичном LZ4 block format:
+// последовательности "токен, литералы, смещение совпадения, длина совпадения"
+std::vector<char> CompressBlock(std::string_view data);
+std::string DecompressBlock(const std::vector<char>& compressed, size_t raw_size);
@@ -0,0 +1,310 @@
+#include "corpus_reader.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <execution>
+#include <future>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std::string_literals;
+
+#ifdef _WIN32
+MappedFile::MappedFile(const std::string& path) {
+    file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE) {
+        file_ = nullptr;
+        throw std::runtime_error("Cannot open file "s + path);
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file_, &file_size)) {
+        CloseHandle(file_);
+        throw std::runtime_error("Cannot get size of file "s + path);
+    }
+    size_ = static_cast<size_t>(file_size.QuadPart);
+    if (size_ == 0) {
+        return;
+    }
+
+    mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_ != nullptr) {
+        data_ = static_cast<const char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+    }
+    if (data_ == nullptr) {
+        if (mapping_ != nullptr) {
+            CloseHandle(mapping_);
+        }
+        CloseHandle(file_);
+        throw std::runtime_error("Cannot map file "s + path);
+    }
+}
+
+MappedFile::~MappedFile() {
+    if (data_ != nullptr) {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_ != nullptr) {
+        CloseHandle(mapping_);
+    }
+    if (file_ != nullptr) {
+        CloseHandle(file_);
+    }
+}
+
+void MappedFile::Release(size_t, size_t) const {
+}
+#else
+MappedFile::MappedFile(const std::string& path) {
+    const int file = open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        throw std::runtime_error("Cannot open file "s + path);
+    }
+
+    struct stat file_stat;
+    if (fstat(file, &file_stat) != 0) {
+        close(file);
+        throw std::runtime_error("Cannot get size of file "s + path);
+    }
+    size_ = static_cast<size_t>(file_stat.st_size);
+    if (size_ == 0) {
+        close(file);
+        return;
+    }
+
+    void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (data == MAP_FAILED) {
+        throw std::runtime_error("Cannot map file "s + path);
+    }
+    madvise(data, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const char*>(data);
+}
+
+MappedFile::~MappedFile() {
+    if (data_ != nullptr) {
+        munmap(const_cast<char*>(data_), size_);
+    }
+}
+
+void MappedFile::Release(size_t offset, size_t size) const {
+    static const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t first = offset / page_size * page_size;
+    const size_t last = std::min(offset + size, size_);
+    if (data_ != nullptr && first < last) {
+        madvise(const_cast<char*>(data_) + first, last - first, MADV_DONTNEED);
+    }
+}
+#endif
+
+std::string_view MappedFile::GetData() const {
+    return { data_, size_ };
+}
+
+std::ostream& operator<<(std::ostream& out, const CorpusIngestionStats& stats) {
+    const double megabytes = stats.byte_count / double(1 << 20);
+    out << stats.document_count << " documents ("s << stats.error_count << " errors), "s
+        << megabytes << " MiB in "s << stats.seconds << " s"s;
+    if (stats.seconds > 0) {
+        out << ", "s << megabytes / stats.seconds << " MiB/s"s;
+    }
+    return out;
+}
+
+namespace {
+
+// Рейтинги документа - участок [ratings_offset, ratings_offset + rating_count) общего буфера фрагмента
+struct CorpusDocument {
+    int id = 0;
+    DocumentStatus status = DocumentStatus::ACTUAL;
+    size_t ratings_offset = 0;
+    size_t rating_count = 0;
+    // Пусто, если строку не удалось разобрать
+    std::optional<SearchServer::TokenizedDocument> document;
+};
+
+// Фрагменты разбираются параллельно, поэтому буфер рейтингов у каждого свой
+struct CorpusChunk {
+    std::vector<CorpusDocument> documents;
+    std::vector<int> ratings;
+};
+
+struct CorpusBatch {
+    size_t offset = 0;
+    size_t size = 0;
+    std::vector<CorpusChunk> chunks;
+};
+
+} // namespace
+
+static std::string_view NextField(std::string_view& line, char separator = '\t') {
+    const size_t end = line.find(separator);
+    const std::string_view field = line.substr(0, end);
+    line.remove_prefix(end == line.npos ? line.size() : end + 1);
+    return field;
+}
+
+static bool ParseInt(std::string_view text, int& value) {
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return error == std::errc{} && end == text.data() + text.size();
+}
+
+static bool ParseStatus(std::string_view text, DocumentStatus& status) {
+    static const std::pair<std::string_view, DocumentStatus> statuses[] = {
+        { "ACTUAL", DocumentStatus::ACTUAL },
+        { "IRRELEVANT", DocumentStatus::IRRELEVANT },
+        { "BANNED", DocumentStatus::BANNED },
+        { "REMOVED", DocumentStatus::REMOVED },
+    };
+    for (const auto& [name, value] : statuses) {
+        if (text == name) {
+            status = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+static CorpusDocument ParseLine(const SearchServer& search_server, std::string_view line,
+    std::vector<int>& ratings) {
+    CorpusDocument result;
+    if (!ParseInt(NextField(line), result.id) || !ParseStatus(NextField(line), result.status)) {
+        return result;
+    }
+    result.ratings_offset = ratings.size();
+    std::string_view rating_field = NextField(line);
+    while (!rating_field.empty()) {
+        const std::string_view rating = NextField(rating_field, ' ');
+        if (rating.empty()) {
+            continue;
+        }
+        if (!ParseInt(rating, ratings.emplace_back())) {
+            ratings.resize(result.ratings_offset);
+            return result;
+        }
+    }
+    result.rating_count = ratings.size() - result.ratings_offset;
+
+    try {
+        result.document = search_server.TokenizeDocument(line);
+    }
+    catch (const std::invalid_argument&) {
+        // Текст с управляющими символами - ошибка строки, document остаётся пустым
+    }
+    return result;
+}
+
+static CorpusChunk ParseChunk(const SearchServer& search_server, std::string_view chunk) {
+    CorpusChunk result;
+    while (!chunk.empty()) {
+        const size_t line_end = chunk.find('\n');
+        std::string_view line = chunk.substr(0, line_end);
+        chunk.remove_prefix(line_end == chunk.npos ? chunk.size() : line_end + 1);
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        if (!line.empty()) {
+            result.documents.push_back(ParseLine(search_server, line, result.ratings));
+        }
+    }
+    return result;
+}
+
+// Делит данные начиная с offset на фрагменты около chunk_size байт, заканчивающиеся на границе строки
+static std::vector<std::string_view> SplitIntoChunks(std::string_view data, size_t offset,
+    const CorpusIngestionOptions& options) {
+    std::vector<std::string_view> chunks;
+    const size_t chunk_count = std::max<size_t>(options.chunks_per_batch, 1);
+    while (offset < data.size() && chunks.size() < chunk_count) {
+        size_t end = std::min(offset + std::max<size_t>(options.chunk_size, 1), data.size());
+        const size_t line_end = data.find('\n', end - 1);
+        end = line_end == data.npos ? data.size() : line_end + 1;
+        chunks.push_back(data.substr(offset, end - offset));
+        offset = end;
+    }
+    return chunks;
+}
+
+static CorpusBatch ParseBatch(const SearchServer& search_server, std::string_view data, size_t offset,
+    const CorpusIngestionOptions& options) {
+    const std::vector<std::string_view> chunks = SplitIntoChunks(data, offset, options);
+
+    CorpusBatch batch;
+    batch.offset = offset;
+    for (const std::string_view chunk : chunks) {
+        batch.size += chunk.size();
+    }
+    batch.chunks.resize(chunks.size());
+    std::transform(std::execution::par,
+        chunks.begin(), chunks.end(), batch.chunks.begin(),
+        [&search_server](std::string_view chunk) {
+            return ParseChunk(search_server, chunk);
+        });
+    return batch;
+}
+
+CorpusIngestionStats IndexCorpusFile(SearchServer& search_server, const std::string& path,
+    const CorpusIngestionOptions& options) {
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start_time = Clock::now();
+
+    const MappedFile file(path);
+    const std::string_view data = file.GetData();
+    CorpusIngestionStats stats;
+
+    // Разбор следующей партии только читает сервер: стоп-слова не меняются во время загрузки
+    const auto parse_batch = [&search_server, data, &options](size_t offset) {
+        return ParseBatch(search_server, data, offset, options);
+    };
+    std::future<CorpusBatch> next_batch = std::async(std::launch::async, parse_batch, 0);
+
+    while (next_batch.valid()) {
+        const CorpusBatch batch = next_batch.get();
+        const size_t next_offset = batch.offset + batch.size;
+        if (next_offset < data.size()) {
+            next_batch = std::async(std::launch::async, parse_batch, next_offset);
+        }
+
+        for (const CorpusChunk& chunk : batch.chunks) {
+            for (const CorpusDocument& document : chunk.documents) {
+                if (!document.document) {
+                    ++stats.error_count;
+                    continue;
+                }
+                try {
+                    const RatingsView ratings(chunk.ratings.data() + document.ratings_offset, document.rating_count);
+                    search_server.AddDocument(document.id, *document.document, document.status, ratings);
+                    ++stats.document_count;
+                }
+                catch (const std::invalid_argument&) {
+                    ++stats.error_count;
+                }
+            }
+        }
+
+        file.Release(batch.offset, batch.size);
+        stats.byte_count = next_offset;
+        stats.seconds = std::chrono::duration<double>(Clock::now() - start_time).count();
+        if (options.progress) {
+            *options.progress << "Indexed "s << stats << std::endl;
+        }
+    }
+
+    stats.seconds = std::chrono::duration<double>(Clock::now() - start_time).count();
+    return stats;
+}
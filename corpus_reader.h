@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "search_server.h"
+
+// Файл, отображённый в память только для чтения
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+
+public:
+    std::string_view GetData() const;
+    // Подсказка системе, что прочитанные страницы больше не нужны
+    void Release(size_t offset, size_t size) const;
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#endif
+};
+
+struct CorpusIngestionOptions {
+    size_t chunk_size = 4 << 20;
+    // Сколько фрагментов разбирается параллельно, пока индексируется предыдущая партия
+    size_t chunks_per_batch = 8;
+    std::ostream* progress = nullptr;
+};
+
+struct CorpusIngestionStats {
+    size_t document_count = 0;
+    size_t error_count = 0;
+    size_t byte_count = 0;
+    double seconds = 0.0;
+};
+
+std::ostream& operator<<(std::ostream& out, const CorpusIngestionStats& stats);
+
+// Загружает корпус, где каждая строка - документ в формате
+// "id<TAB>статус<TAB>рейтинги через пробел<TAB>текст", статус - ACTUAL, IRRELEVANT, BANNED или REMOVED.
+// Разбор строк и слов выполняется параллельно с индексированием предыдущей партии,
+// в памяти одновременно находятся не более двух партий разобранных документов
+CorpusIngestionStats IndexCorpusFile(SearchServer& search_server, const std::string& path,
+    const CorpusIngestionOptions& options = {});
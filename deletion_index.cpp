@@ -0,0 +1,107 @@
+#include "deletion_index.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <unordered_set>
+
+DeletionIndex::DeletionIndex(int max_distance)
+    : max_distance_(max_distance) {
+}
+
+void DeletionIndex::Add(std::string_view word) {
+    for (std::string& deleted : GenerateDeletes(word)) {
+        deletes_[std::move(deleted)].push_back(word);
+    }
+}
+
+void DeletionIndex::Remove(std::string_view word) {
+    for (const std::string& deleted : GenerateDeletes(word)) {
+        const auto it = deletes_.find(deleted);
+        if (it == deletes_.end()) {
+            continue;
+        }
+        auto& words = it->second;
+        words.erase(std::remove(words.begin(), words.end(), word), words.end());
+        if (words.empty()) {
+            deletes_.erase(it);
+        }
+    }
+}
+
+std::vector<std::pair<std::string_view, int>> DeletionIndex::Lookup(std::string_view word) const {
+    std::vector<std::pair<std::string_view, int>> result;
+    std::unordered_set<std::string_view> checked_words;
+    for (const std::string& deleted : GenerateDeletes(word)) {
+        const auto it = deletes_.find(deleted);
+        if (it == deletes_.end()) {
+            continue;
+        }
+        for (std::string_view candidate : it->second) {
+            if (!checked_words.insert(candidate).second) {
+                continue;
+            }
+            const int distance = ComputeEditDistance(word, candidate, max_distance_);
+            if (distance <= max_distance_) {
+                result.push_back({ candidate, distance });
+            }
+        }
+    }
+    return result;
+}
+
+int DeletionIndex::GetMaxDistance() const {
+    return max_distance_;
+}
+
+std::vector<std::string> DeletionIndex::GenerateDeletes(std::string_view word) const {
+    std::vector<std::string> deletes{ std::string(word.substr(0, PREFIX_LENGTH)) };
+    std::unordered_set<std::string> seen{ deletes.front() };
+    for (size_t begin = 0, distance = 0; distance < static_cast<size_t>(max_distance_); ++distance) {
+        const size_t end = deletes.size();
+        for (size_t i = begin; i < end; ++i) {
+            for (size_t pos = 0; pos < deletes[i].size(); ++pos) {
+                std::string deleted = deletes[i];
+                deleted.erase(pos, 1);
+                if (seen.insert(deleted).second) {
+                    deletes.push_back(std::move(deleted));
+                }
+            }
+        }
+        begin = end;
+    }
+    return deletes;
+}
+
+// Расстояние Дамерау-Левенштейна (с транспозицией соседних символов).
+// Если расстояние больше max_distance, возвращается max_distance + 1
+int ComputeEditDistance(std::string_view lhs, std::string_view rhs, int max_distance) {
+    const int length_difference = static_cast<int>(lhs.size()) - static_cast<int>(rhs.size());
+    if (std::abs(length_difference) > max_distance) {
+        return max_distance + 1;
+    }
+
+    const size_t columns = rhs.size() + 1;
+    std::vector<int> before_previous(columns), previous(columns), current(columns);
+    for (size_t j = 0; j < columns; ++j) {
+        previous[j] = static_cast<int>(j);
+    }
+
+    for (size_t i = 1; i <= lhs.size(); ++i) {
+        current[0] = static_cast<int>(i);
+        int row_min = current[0];
+        for (size_t j = 1; j < columns; ++j) {
+            const int cost = lhs[i - 1] == rhs[j - 1] ? 0 : 1;
+            current[j] = std::min({ previous[j] + 1, current[j - 1] + 1, previous[j - 1] + cost });
+            if (i > 1 && j > 1 && lhs[i - 1] == rhs[j - 2] && lhs[i - 2] == rhs[j - 1]) {
+                current[j] = std::min(current[j], before_previous[j - 2] + 1);
+            }
+            row_min = std::min(row_min, current[j]);
+        }
+        if (row_min > max_distance) {
+            return max_distance + 1;
+        }
+        std::swap(before_previous, previous);
+        std::swap(previous, current);
+    }
+    return std::min(previous[rhs.size()], max_distance + 1);
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Индекс удалений (SymSpell): каждое слово словаря доступно по всем строкам,
+// получаемым из его префикса удалением не более max_distance символов.
+// Поиск похожих слов не перебирает словарь, а проверяет только кандидатов с общими удалениями
+class DeletionIndex {
+public:
+    explicit DeletionIndex(int max_distance);
+
+public:
+    void Add(std::string_view word);
+    void Remove(std::string_view word);
+    std::vector<std::pair<std::string_view, int>> Lookup(std::string_view word) const;
+    int GetMaxDistance() const;
+
+private:
+    static const size_t PREFIX_LENGTH = 7;
+
+private:
+    std::vector<std::string> GenerateDeletes(std::string_view word) const;
+
+private:
+    int max_distance_;
+    std::unordered_map<std::string, std::vector<std::string_view>> deletes_;
+};
+
+int ComputeEditDistance(std::string_view lhs, std::string_view rhs, int max_distance);
@@ -1,10 +1,19 @@
 #pragma once
 #include <iostream>
+#include <limits>
+#include <optional>
 #include <vector>
 
+#include "query_plan.h"
+
 using namespace std::string_literals;
 
 const int MAX_RESULT_DOCUMENT_COUNT = 5;
+const size_t MAX_WILDCARD_EXPANSION = 64;
+const size_t MAX_WILDCARD_SCAN = 4096;
+const double FUZZY_MATCH_DISCOUNT = 0.5;
+// Документы с релевантностью, отличающейся меньше чем на RELEVANCE_EPSILON, упорядочиваются по рейтингу
+const double RELEVANCE_EPSILON = 1e-6;
 
 enum class DocumentStatus {
     ACTUAL,
@@ -13,6 +22,22 @@ enum class DocumentStatus {
     REMOVED,
 };
 
+// Фильтр по статусу и диапазону рейтинга, вычисляемый по битовым индексам сервера
+struct DocumentFilter {
+    std::optional<DocumentStatus> status;
+    int min_rating = std::numeric_limits<int>::min();
+    int max_rating = std::numeric_limits<int>::max();
+};
+
+// Параметры отдельного запроса. При max_edit_distance > 0 слова запроса дополняются словами
+// словаря на расстоянии редактирования до max_edit_distance (индекс строится SetFuzzySearch).
+// strategy заменяет выбор планировщика, например для сравнения стратегий; INTERSECTION
+// допустима только для запроса с фразой
+struct SearchOptions {
+    int max_edit_distance = 0;
+    std::optional<QueryStrategy> strategy = std::nullopt;
+};
+
 struct Document {
     Document();
     Document(int id, double relevance, int rating);
@@ -0,0 +1,74 @@
+#pragma once
+#include <type_traits>
+
+#include "bitmap.h"
+#include "document.h"
+#include "ratings.h"
+
+// Фильтры-политики для FindTopDocuments. Как и произвольный предикат, фильтр вызывается
+// с (document_id, status, rating); фильтру с NEEDS_DOCUMENT_DATA == false данные документа
+// не нужны, и он вызывается только с document_id без обращения к данным документа.
+// Фильтру с NEEDS_RATING_STATS == true вместо среднего рейтинга передаётся RatingStats документа.
+// Тип фильтра известен на этапе компиляции, поэтому проверка встраивается в цикл подсчёта релевантности
+// Фильтр по статусу и рейтингу задаётся DocumentFilter: сервер сам выбирает для него BitmapFilter
+// по своим битовым индексам или DocumentFilterPredicate
+
+struct NoFilter {
+    static constexpr bool NEEDS_DOCUMENT_DATA = false;
+
+    constexpr bool operator()(int) const {
+        return true;
+    }
+};
+
+// Документы, оценённые не менее min_count раз
+struct RatingCountFilter {
+    static constexpr bool NEEDS_DOCUMENT_DATA = true;
+    static constexpr bool NEEDS_RATING_STATS = true;
+
+    bool operator()(int, DocumentStatus, const RatingStats& ratings) const {
+        return ratings.count >= min_count;
+    }
+
+    size_t min_count = 0;
+};
+
+// DocumentFilter, проверяемый по данным документа для каждого вхождения
+struct DocumentFilterPredicate {
+    static constexpr bool NEEDS_DOCUMENT_DATA = true;
+
+    bool operator()(int, DocumentStatus document_status, int rating) const {
+        return (!filter.status || document_status == *filter.status)
+            && rating >= filter.min_rating && rating <= filter.max_rating;
+    }
+
+    const DocumentFilter& filter;
+};
+
+struct BitmapFilter {
+    static constexpr bool NEEDS_DOCUMENT_DATA = false;
+
+    bool operator()(int document_id) const {
+        return documents.Contains(document_id);
+    }
+
+    const Bitmap& documents;
+};
+
+template <typename Filter, typename = void>
+struct NeedsDocumentData : std::true_type {
+};
+
+template <typename Filter>
+struct NeedsDocumentData<Filter, std::void_t<decltype(Filter::NEEDS_DOCUMENT_DATA)>>
+    : std::bool_constant<Filter::NEEDS_DOCUMENT_DATA> {
+};
+
+template <typename Filter, typename = void>
+struct NeedsRatingStats : std::false_type {
+};
+
+template <typename Filter>
+struct NeedsRatingStats<Filter, std::void_t<decltype(Filter::NEEDS_RATING_STATS)>>
+    : std::bool_constant<Filter::NEEDS_RATING_STATS> {
+};
@@ -0,0 +1,165 @@
+#include "document_store.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "block_compression.h"
+
+DocumentStore::DocumentStore(size_t block_size)
+    : block_size_(block_size) {
+}
+
+void DocumentStore::SetCompression(TextCompression compression) {
+    compression_ = compression;
+}
+
+void DocumentStore::Add(int document_id, std::string_view text) {
+    if (!current_block_.empty() && current_block_.size() + text.size() > block_size_) {
+        SealCurrentBlock();
+    }
+
+    if (current_block_.empty()) {
+        current_block_.reserve(std::max(block_size_, text.size()));
+    }
+    locations_[document_id] = { blocks_.size(), current_block_.size(), text.size() };
+    current_block_.append(text);
+    stored_size_ += text.size();
+}
+
+void DocumentStore::Remove(int document_id) {
+    const auto location_it = locations_.find(document_id);
+    if (location_it == locations_.end()) {
+        return;
+    }
+
+    removed_size_ += location_it->second.size;
+    locations_.erase(location_it);
+    if (removed_size_ * 2 > stored_size_) {
+        Compact();
+    }
+}
+
+std::string DocumentStore::Get(int document_id) const {
+    const auto location_it = locations_.find(document_id);
+    if (location_it == locations_.end()) {
+        return {};
+    }
+
+    const Location& location = location_it->second;
+    if (location.block == blocks_.size()) {
+        return current_block_.substr(location.offset, location.size);
+    }
+    const Block& block = blocks_[location.block];
+    if (!block.is_compressed) {
+        return { block.data.data() + location.offset, location.size };
+    }
+    return DecompressBlock(block.data, block.raw_size).substr(location.offset, location.size);
+}
+
+std::vector<std::string> DocumentStore::Get(const std::vector<int>& document_ids) const {
+    std::vector<std::string> texts(document_ids.size());
+    std::vector<std::pair<Location, size_t>> requests;
+    requests.reserve(document_ids.size());
+    for (size_t i = 0; i < document_ids.size(); ++i) {
+        const auto location_it = locations_.find(document_ids[i]);
+        if (location_it != locations_.end()) {
+            requests.push_back({ location_it->second, i });
+        }
+    }
+
+    // Каждый блок распаковывается один раз, даже если в нём несколько запрошенных документов
+    std::sort(requests.begin(), requests.end(),
+        [](const auto& lhs, const auto& rhs) {
+            return lhs.first.block < rhs.first.block;
+        });
+
+    std::string block_text;
+    size_t loaded_block = blocks_.size() + 1;
+    for (const auto& [location, index] : requests) {
+        if (location.block == blocks_.size()) {
+            texts[index] = current_block_.substr(location.offset, location.size);
+            continue;
+        }
+        const Block& block = blocks_[location.block];
+        if (!block.is_compressed) {
+            texts[index].assign(block.data.data() + location.offset, location.size);
+            continue;
+        }
+        if (location.block != loaded_block) {
+            block_text = DecompressBlock(block.data, block.raw_size);
+            loaded_block = location.block;
+        }
+        texts[index] = block_text.substr(location.offset, location.size);
+    }
+    return texts;
+}
+
+size_t DocumentStore::GetMemoryUsage() const {
+    size_t memory = current_block_.capacity() + blocks_.capacity() * sizeof(Block);
+    for (const Block& block : blocks_) {
+        memory += block.data.capacity();
+    }
+    return memory;
+}
+
+void DocumentStore::SealCurrentBlock() {
+    Block block;
+    block.raw_size = current_block_.size();
+    if (compression_ == TextCompression::LZ) {
+        std::vector<char> compressed = CompressBlock(current_block_);
+        if (compressed.size() < current_block_.size()) {
+            compressed.shrink_to_fit();
+            block.data = std::move(compressed);
+            block.is_compressed = true;
+        }
+    }
+    if (!block.is_compressed) {
+        block.data.assign(current_block_.begin(), current_block_.end());
+    }
+
+    blocks_.push_back(std::move(block));
+    current_block_.clear();
+    current_block_.shrink_to_fit();
+}
+
+// Переносит тексты оставшихся документов в новые блоки в порядке их расположения,
+// каждый сжатый блок распаковывается один раз
+void DocumentStore::Compact() {
+    std::vector<std::pair<Location, int>> documents;
+    documents.reserve(locations_.size());
+    for (const auto& [document_id, location] : locations_) {
+        documents.push_back({ location, document_id });
+    }
+    std::sort(documents.begin(), documents.end(),
+        [](const auto& lhs, const auto& rhs) {
+            return std::pair{ lhs.first.block, lhs.first.offset } < std::pair{ rhs.first.block, rhs.first.offset };
+        });
+
+    const std::vector<Block> blocks = std::move(blocks_);
+    const std::string current_block = std::move(current_block_);
+    blocks_.clear();
+    current_block_.clear();
+    locations_.clear();
+    stored_size_ = 0;
+    removed_size_ = 0;
+
+    std::string block_text;
+    size_t loaded_block = blocks.size() + 1;
+    for (const auto& [location, document_id] : documents) {
+        std::string_view text;
+        if (location.block == blocks.size()) {
+            text = current_block;
+        }
+        else if (!blocks[location.block].is_compressed) {
+            text = { blocks[location.block].data.data(), blocks[location.block].data.size() };
+        }
+        else {
+            if (location.block != loaded_block) {
+                block_text = DecompressBlock(blocks[location.block].data, blocks[location.block].raw_size);
+                loaded_block = location.block;
+            }
+            text = block_text;
+        }
+        Add(document_id, text.substr(location.offset, location.size));
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class TextCompression {
+    NONE,
+    LZ,
+};
+
+// Хранит исходные тексты документов в крупных непрерывных блоках.
+// Заполненные блоки могут сжиматься; текущий блок всегда хранится как есть.
+// Тексты удалённых документов остаются в блоках, пока их объём не превысит объём
+// оставшихся текстов, после чего все блоки переписываются заново
+class DocumentStore {
+public:
+    explicit DocumentStore(size_t block_size = 64 * 1024);
+
+public:
+    void SetCompression(TextCompression compression);
+    void Add(int document_id, std::string_view text);
+    void Remove(int document_id);
+    std::string Get(int document_id) const;
+    std::vector<std::string> Get(const std::vector<int>& document_ids) const;
+    size_t GetMemoryUsage() const;
+
+private:
+    struct Location {
+        size_t block = 0;
+        size_t offset = 0;
+        size_t size = 0;
+    };
+
+    struct Block {
+        std::vector<char> data;
+        size_t raw_size = 0;
+        bool is_compressed = false;
+    };
+
+private:
+    void SealCurrentBlock();
+    void Compact();
+
+private:
+    TextCompression compression_ = TextCompression::NONE;
+    size_t block_size_;
+    std::vector<Block> blocks_;
+    std::string current_block_;
+    std::map<int, Location> locations_;
+    size_t stored_size_ = 0;
+    size_t removed_size_ = 0;
+};
@@ -0,0 +1,186 @@
+#include "forward_index.h"
+
+ForwardIndex::WordFrequencies::Iterator::Iterator(const std::vector<std::string_view>* words,
+    const uint32_t* word_ids, const double* freqs, size_t index)
+    : words_(words)
+    , word_ids_(word_ids)
+    , freqs_(freqs)
+    , index_(index) {
+}
+
+ForwardIndex::WordFrequencies::Iterator::value_type ForwardIndex::WordFrequencies::Iterator::operator*() const {
+    return { (*words_)[word_ids_[index_]], freqs_[index_] };
+}
+
+ForwardIndex::WordFrequencies::Iterator::value_type
+ForwardIndex::WordFrequencies::Iterator::operator[](difference_type offset) const {
+    return *(*this + offset);
+}
+
+ForwardIndex::WordFrequencies::Iterator& ForwardIndex::WordFrequencies::Iterator::operator++() {
+    ++index_;
+    return *this;
+}
+
+ForwardIndex::WordFrequencies::Iterator ForwardIndex::WordFrequencies::Iterator::operator++(int) {
+    Iterator prev = *this;
+    ++index_;
+    return prev;
+}
+
+ForwardIndex::WordFrequencies::Iterator& ForwardIndex::WordFrequencies::Iterator::operator--() {
+    --index_;
+    return *this;
+}
+
+ForwardIndex::WordFrequencies::Iterator ForwardIndex::WordFrequencies::Iterator::operator--(int) {
+    Iterator prev = *this;
+    --index_;
+    return prev;
+}
+
+ForwardIndex::WordFrequencies::Iterator& ForwardIndex::WordFrequencies::Iterator::operator+=(difference_type offset) {
+    index_ += offset;
+    return *this;
+}
+
+ForwardIndex::WordFrequencies::Iterator& ForwardIndex::WordFrequencies::Iterator::operator-=(difference_type offset) {
+    index_ -= offset;
+    return *this;
+}
+
+ForwardIndex::WordFrequencies::Iterator ForwardIndex::WordFrequencies::Iterator::operator+(difference_type offset) const {
+    return Iterator(words_, word_ids_, freqs_, index_ + offset);
+}
+
+ForwardIndex::WordFrequencies::Iterator ForwardIndex::WordFrequencies::Iterator::operator-(difference_type offset) const {
+    return Iterator(words_, word_ids_, freqs_, index_ - offset);
+}
+
+ForwardIndex::WordFrequencies::Iterator::difference_type
+ForwardIndex::WordFrequencies::Iterator::operator-(const Iterator& other) const {
+    return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+}
+
+bool ForwardIndex::WordFrequencies::Iterator::operator==(const Iterator& other) const {
+    return index_ == other.index_;
+}
+
+bool ForwardIndex::WordFrequencies::Iterator::operator!=(const Iterator& other) const {
+    return index_ != other.index_;
+}
+
+bool ForwardIndex::WordFrequencies::Iterator::operator<(const Iterator& other) const {
+    return index_ < other.index_;
+}
+
+bool ForwardIndex::WordFrequencies::Iterator::operator>(const Iterator& other) const {
+    return index_ > other.index_;
+}
+
+bool ForwardIndex::WordFrequencies::Iterator::operator<=(const Iterator& other) const {
+    return index_ <= other.index_;
+}
+
+bool ForwardIndex::WordFrequencies::Iterator::operator>=(const Iterator& other) const {
+    return index_ >= other.index_;
+}
+
+ForwardIndex::WordFrequencies::WordFrequencies(const std::vector<std::string_view>* words,
+    const uint32_t* word_ids, const double* freqs, size_t size)
+    : words_(words)
+    , word_ids_(word_ids)
+    , freqs_(freqs)
+    , size_(size) {
+}
+
+ForwardIndex::WordFrequencies::Iterator ForwardIndex::WordFrequencies::begin() const {
+    return Iterator(words_, word_ids_, freqs_, 0);
+}
+
+ForwardIndex::WordFrequencies::Iterator ForwardIndex::WordFrequencies::end() const {
+    return Iterator(words_, word_ids_, freqs_, size_);
+}
+
+size_t ForwardIndex::WordFrequencies::size() const {
+    return size_;
+}
+
+bool ForwardIndex::WordFrequencies::empty() const {
+    return size_ == 0;
+}
+
+void ForwardIndex::Add(int document_id, const std::map<std::string_view, double>& word_freqs) {
+    document_ranges_[document_id] = { word_ids_.size(), word_freqs.size() };
+    for (const auto& [word, freq] : word_freqs) {
+        word_ids_.push_back(GetWordId(word));
+        freqs_.push_back(freq);
+    }
+}
+
+void ForwardIndex::Remove(int document_id) {
+    const auto range_it = document_ranges_.find(document_id);
+    if (range_it == document_ranges_.end()) {
+        return;
+    }
+
+    removed_count_ += range_it->second.size;
+    document_ranges_.erase(range_it);
+    if (removed_count_ * 2 > word_ids_.size()) {
+        Compact();
+    }
+}
+
+ForwardIndex::WordFrequencies ForwardIndex::Get(int document_id) const {
+    const auto range_it = document_ranges_.find(document_id);
+    if (range_it == document_ranges_.end()) {
+        return {};
+    }
+
+    const Range& range = range_it->second;
+    return { &words_, word_ids_.data() + range.offset, freqs_.data() + range.offset, range.size };
+}
+
+std::string_view ForwardIndex::FindWord(std::string_view word) const {
+    const auto word_it = word_to_id_.find(word);
+    return word_it == word_to_id_.end() ? std::string_view{} : word_it->first;
+}
+
+size_t ForwardIndex::GetEntryCount() const {
+    return word_ids_.size() - removed_count_;
+}
+
+size_t ForwardIndex::GetMemoryUsage() const {
+    const size_t map_node_overhead = 4 * sizeof(void*);
+    const size_t hash_node_overhead = 2 * sizeof(void*);
+    return words_.capacity() * sizeof(std::string_view)
+        + word_to_id_.bucket_count() * sizeof(void*)
+        + word_to_id_.size() * (sizeof(std::pair<std::string_view, uint32_t>) + hash_node_overhead)
+        + word_ids_.capacity() * sizeof(uint32_t)
+        + freqs_.capacity() * sizeof(double)
+        + document_ranges_.size() * (sizeof(std::pair<int, Range>) + map_node_overhead);
+}
+
+uint32_t ForwardIndex::GetWordId(std::string_view word) {
+    const auto [word_it, inserted] = word_to_id_.emplace(word, static_cast<uint32_t>(words_.size()));
+    if (inserted) {
+        words_.push_back(word);
+    }
+    return word_it->second;
+}
+
+void ForwardIndex::Compact() {
+    std::vector<uint32_t> word_ids;
+    std::vector<double> freqs;
+    word_ids.reserve(GetEntryCount());
+    freqs.reserve(GetEntryCount());
+    for (auto& [_, range] : document_ranges_) {
+        const size_t offset = word_ids.size();
+        word_ids.insert(word_ids.end(), word_ids_.begin() + range.offset, word_ids_.begin() + range.offset + range.size);
+        freqs.insert(freqs.end(), freqs_.begin() + range.offset, freqs_.begin() + range.offset + range.size);
+        range.offset = offset;
+    }
+    word_ids_ = std::move(word_ids);
+    freqs_ = std::move(freqs);
+    removed_count_ = 0;
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Прямой индекс: слова и частоты всех документов лежат подряд в двух общих массивах,
+// слово хранится своим номером в словаре индекса.
+// Место удалённых документов освобождается, когда его становится больше занятого
+class ForwardIndex {
+public:
+    // Представление частот слов одного документа, действительно до изменения индекса
+    class WordFrequencies {
+    public:
+        class Iterator {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = std::pair<std::string_view, double>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = value_type;
+
+        public:
+            Iterator() = default;
+            Iterator(const std::vector<std::string_view>* words, const uint32_t* word_ids,
+                const double* freqs, size_t index);
+
+        public:
+            value_type operator*() const;
+            value_type operator[](difference_type offset) const;
+            Iterator& operator++();
+            Iterator operator++(int);
+            Iterator& operator--();
+            Iterator operator--(int);
+            Iterator& operator+=(difference_type offset);
+            Iterator& operator-=(difference_type offset);
+            Iterator operator+(difference_type offset) const;
+            Iterator operator-(difference_type offset) const;
+            difference_type operator-(const Iterator& other) const;
+            bool operator==(const Iterator& other) const;
+            bool operator!=(const Iterator& other) const;
+            bool operator<(const Iterator& other) const;
+            bool operator>(const Iterator& other) const;
+            bool operator<=(const Iterator& other) const;
+            bool operator>=(const Iterator& other) const;
+
+        private:
+            const std::vector<std::string_view>* words_ = nullptr;
+            const uint32_t* word_ids_ = nullptr;
+            const double* freqs_ = nullptr;
+            size_t index_ = 0;
+        };
+
+    public:
+        WordFrequencies() = default;
+        WordFrequencies(const std::vector<std::string_view>* words, const uint32_t* word_ids,
+            const double* freqs, size_t size);
+
+    public:
+        Iterator begin() const;
+        Iterator end() const;
+        size_t size() const;
+        bool empty() const;
+
+    private:
+        const std::vector<std::string_view>* words_ = nullptr;
+        const uint32_t* word_ids_ = nullptr;
+        const double* freqs_ = nullptr;
+        size_t size_ = 0;
+    };
+
+public:
+    void Add(int document_id, const std::map<std::string_view, double>& word_freqs);
+    void Remove(int document_id);
+    WordFrequencies Get(int document_id) const;
+    // Слово из словаря индекса или пустая строка. Слова не удаляются из словаря,
+    // поэтому представление остаётся валидным и после удаления всех документов со словом
+    std::string_view FindWord(std::string_view word) const;
+    size_t GetEntryCount() const;
+    size_t GetMemoryUsage() const;
+
+private:
+    struct Range {
+        size_t offset = 0;
+        size_t size = 0;
+    };
+
+private:
+    uint32_t GetWordId(std::string_view word);
+    void Compact();
+
+private:
+    std::vector<std::string_view> words_;
+    std::unordered_map<std::string_view, uint32_t> word_to_id_;
+    std::vector<uint32_t> word_ids_;
+    std::vector<double> freqs_;
+    std::map<int, Range> document_ranges_;
+    size_t removed_count_ = 0;
+};
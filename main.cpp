@@ -1,5 +1,8 @@
-﻿#include "process_queries.h"
+﻿#include "benchmark.h"
+#include "corpus_reader.h"
+#include "process_queries.h"
 #include "search_server.h"
+#include "tests.h"
 
 #include <execution>
 #include <iostream>
@@ -15,7 +18,34 @@ using namespace std;
 //        << "rating = "s << document.rating << " }"s << endl;
 //}
 
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc > 1 && argv[1] == "--test"s) {
+        RunTests();
+        return 0;
+    }
+    if (argc > 1 && argv[1] == "--benchmark"s) {
+        BenchmarkFilterKernels();
+        BenchmarkRatingFilters();
+        BenchmarkScorers();
+        ReportQueryPlans();
+        BenchmarkRatingStats();
+        ReportForwardIndexMemory();
+        return 0;
+    }
+    if (argc > 2 && argv[1] == "--index"s) {
+        SearchServer search_server("and with"s);
+        CorpusIngestionOptions options;
+        options.progress = &cerr;
+        const CorpusIngestionStats stats = IndexCorpusFile(search_server, argv[2], options);
+        cout << "Indexed "s << stats << endl;
+        for (int i = 3; i < argc; ++i) {
+            for (const Document& document : search_server.FindTopDocuments(execution::par, argv[i])) {
+                PrintDocument(document);
+            }
+        }
+        return 0;
+    }
+
     SearchServer search_server("and with"s);
 
     int id = 0;
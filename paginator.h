@@ -1,6 +1,9 @@
 #pragma once
+#include <algorithm>
 #include <iostream>
-#include <vector>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
 
 template <typename Iterator>
 class IteratorRange {
@@ -37,38 +40,110 @@ std::ostream& operator<<(std::ostream& out, const IteratorRange<Iterator>& range
     return out;
 }
 
+// Страницы не хранятся, а вычисляются при обращении к ним:
+// для итераторов произвольного доступа граница страницы находится за O(1)
 template <typename Iterator>
 class Paginator {
 public:
-    Paginator(Iterator begin, Iterator end, size_t page_size) {
-        for (size_t left = distance(begin, end); left > 0;) {
-            const size_t current_page_size = std::min(page_size, left);
-            const Iterator current_page_end = next(begin, current_page_size);
-            pages_.push_back({ begin, current_page_end });
-
-            left -= current_page_size;
-            begin = current_page_end;
+    class PageIterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = IteratorRange<Iterator>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = IteratorRange<Iterator>;
+
+    public:
+        PageIterator(Iterator page_begin, Iterator end, size_t page_size)
+            : page_begin_(page_begin)
+            , page_end_(Advance(page_begin, end, page_size))
+            , end_(end)
+            , page_size_(page_size) {
+        }
+
+    public:
+        IteratorRange<Iterator> operator*() const {
+            return { page_begin_, page_end_ };
+        }
+
+        PageIterator& operator++() {
+            page_begin_ = page_end_;
+            page_end_ = Advance(page_begin_, end_, page_size_);
+            return *this;
+        }
+
+        PageIterator operator++(int) {
+            PageIterator prev = *this;
+            ++(*this);
+            return prev;
+        }
+
+        bool operator==(const PageIterator& other) const {
+            return page_begin_ == other.page_begin_;
+        }
+
+        bool operator!=(const PageIterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        Iterator page_begin_, page_end_, end_;
+        size_t page_size_;
+    };
+
+public:
+    Paginator(Iterator begin, Iterator end, size_t page_size)
+        : begin_(begin)
+        , end_(end)
+        , page_size_(page_size) {
+        if (page_size_ == 0) {
+            using namespace std::string_literals;
+            throw std::invalid_argument("Page size must be positive"s);
         }
     }
 
 public:
-    auto begin() const {
-        return pages_.begin();
+    PageIterator begin() const {
+        return { begin_, end_, page_size_ };
     }
 
-    auto end() const {
-        return pages_.end();
+    PageIterator end() const {
+        return { end_, end_, page_size_ };
     }
 
     size_t size() const {
-        return pages_.size();
+        const size_t items_count = distance(begin_, end_);
+        return items_count / page_size_ + (items_count % page_size_ != 0);
+    }
+
+    IteratorRange<Iterator> operator[](size_t page) const {
+        const size_t items_count = distance(begin_, end_);
+        const size_t offset = std::min(page, items_count / page_size_ + 1) * page_size_;
+        const Iterator page_begin = Advance(begin_, end_, offset);
+        return { page_begin, Advance(page_begin, end_, page_size_) };
     }
 
 private:
-    std::vector<IteratorRange<Iterator>> pages_;
+    static Iterator Advance(Iterator it, Iterator end, size_t count) {
+        using Category = typename std::iterator_traits<Iterator>::iterator_category;
+        if constexpr (std::is_base_of_v<std::random_access_iterator_tag, Category>) {
+            const size_t left = static_cast<size_t>(end - it);
+            return it + std::min(count, left);
+        }
+        else {
+            for (; count > 0 && it != end; --count) {
+                ++it;
+            }
+            return it;
+        }
+    }
+
+private:
+    Iterator begin_, end_;
+    size_t page_size_;
 };
 
 template <typename Container>
 auto Paginate(const Container& c, size_t page_size) {
     return Paginator(begin(c), end(c), page_size);
-}
\ No newline at end of file
+}
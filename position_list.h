@@ -0,0 +1,15 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// Возрастающий список позиций слова в документе.
+// Хранится в виде разностей соседних позиций, закодированных varint
+class PositionList {
+public:
+    void Add(uint32_t position);
+    std::vector<uint32_t> Decode() const;
+
+private:
+    std::vector<uint8_t> data_;
+    uint32_t last_position_ = 0;
+};
@@ -0,0 +1,46 @@
+#include "query_plan.h"
+
+#include <string>
+
+using namespace std::string_literals;
+
+std::ostream& operator<<(std::ostream& out, QueryStrategy strategy) {
+    switch (strategy) {
+    case QueryStrategy::ACCUMULATOR:
+        return out << "ACCUMULATOR"s;
+    case QueryStrategy::DOCUMENT_AT_A_TIME:
+        return out << "DOCUMENT_AT_A_TIME"s;
+    case QueryStrategy::INTERSECTION:
+        return out << "INTERSECTION"s;
+    }
+    return out;
+}
+
+static void PrintTerms(std::ostream& out, const std::vector<PlannedTerm>& terms) {
+    bool is_first = true;
+    for (const PlannedTerm& term : terms) {
+        out << (is_first ? " "s : ", "s) << term.word << " (df = "s << term.document_freq
+            << ", idf = "s << term.inverse_document_freq;
+        if (term.weight != 1.0) {
+            out << ", weight = "s << term.weight;
+        }
+        out << ")"s;
+        is_first = false;
+    }
+}
+
+std::ostream& operator<<(std::ostream& out, const QueryPlan& plan) {
+    out << "strategy: "s << plan.strategy << (plan.is_parallel ? ", parallel"s : ", sequential"s)
+        << ", estimated cost: "s << plan.estimated_cost << std::endl;
+    out << "plus words:"s;
+    PrintTerms(out, plan.plus_terms);
+    out << std::endl << "minus words:"s;
+    PrintTerms(out, plan.minus_terms);
+    out << std::endl << "phrases: "s << plan.phrase_count << std::endl;
+    out << "costs: accumulator = "s << plan.accumulator_cost
+        << ", document-at-a-time = "s << plan.document_at_a_time_cost;
+    if (plan.phrase_count > 0) {
+        out << ", intersection = "s << plan.intersection_cost;
+    }
+    return out << std::endl;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstddef>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+// Запросы дешевле этой оценки выполняются последовательно даже при параллельной политике
+const size_t PARALLEL_QUERY_COST_THRESHOLD = 100'000;
+
+// ACCUMULATOR - слова обрабатываются по очереди, вклады накапливаются по документам;
+// DOCUMENT_AT_A_TIME - списки вхождений сливаются по возрастанию id, документы
+// с минус-словами отбрасываются до вычисления релевантности, а не попадающие
+// в запрошенные результаты по верхним оценкам слов - до её полного подсчёта;
+// INTERSECTION - кандидаты берутся из самого короткого списка слов фразы
+// и проверяются поиском в остальных списках
+enum class QueryStrategy {
+    ACCUMULATOR,
+    DOCUMENT_AT_A_TIME,
+    INTERSECTION,
+};
+
+struct PlannedTerm {
+    std::string_view word;
+    double weight = 1.0;
+    size_t document_freq = 0;
+    double inverse_document_freq = 0.0;
+    double max_term_freq = 0.0;
+};
+
+// Слова упорядочены от редких к частым, стоимость - оценка числа операций над вхождениями
+struct QueryPlan {
+    QueryStrategy strategy = QueryStrategy::ACCUMULATOR;
+    bool is_parallel = false;
+    std::vector<PlannedTerm> plus_terms;
+    std::vector<PlannedTerm> minus_terms;
+    size_t phrase_count = 0;
+    size_t accumulator_cost = 0;
+    size_t document_at_a_time_cost = 0;
+    size_t intersection_cost = 0;
+    size_t estimated_cost = 0;
+};
+
+std::ostream& operator<<(std::ostream& out, QueryStrategy strategy);
+std::ostream& operator<<(std::ostream& out, const QueryPlan& plan);
@@ -0,0 +1,77 @@
+#include "rating_index.h"
+
+#include <limits>
+
+void RatingIndex::Add(int document_id, int rating) {
+    const uint32_t key = ToKey(rating);
+    for (int bit = 0; bit < BIT_COUNT; ++bit) {
+        if ((key >> bit) & 1) {
+            slices_[bit].Add(document_id);
+        }
+    }
+    documents_.Add(document_id);
+}
+
+void RatingIndex::Remove(int document_id, int rating) {
+    const uint32_t key = ToKey(rating);
+    for (int bit = 0; bit < BIT_COUNT; ++bit) {
+        if ((key >> bit) & 1) {
+            slices_[bit].Remove(document_id);
+        }
+    }
+    documents_.Remove(document_id);
+}
+
+Bitmap RatingIndex::Find(int min_rating, int max_rating) const {
+    if (min_rating > max_rating) {
+        return {};
+    }
+    Bitmap documents = max_rating == std::numeric_limits<int>::max()
+        ? documents_ : FindLessOrEqual(ToKey(max_rating));
+    if (min_rating != std::numeric_limits<int>::min()) {
+        documents -= FindLessOrEqual(ToKey(min_rating) - 1);
+    }
+    return documents;
+}
+
+// После смещения знакового бита порядок ключей совпадает с порядком рейтингов
+uint32_t RatingIndex::ToKey(int rating) {
+    return static_cast<uint32_t>(rating) ^ (uint32_t{ 1 } << 31);
+}
+
+// Срезы просматриваются от младшего бита: documents - документы, ключ которых в уже
+// просмотренных битах не больше key. Если у key бит равен 1, к ним добавляются все документы
+// с нулевым битом, иначе документы с единичным битом исключаются.
+// Младшие единичные биты key не исключают ни одного документа и пропускаются.
+// Пустой срез и срез со всеми документами обрабатываются без операций над картами:
+// при близких рейтингах таковы почти все старшие срезы
+Bitmap RatingIndex::FindLessOrEqual(uint32_t key) const {
+    Bitmap documents = documents_;
+    int bit = 0;
+    while (bit < BIT_COUNT && ((key >> bit) & 1)) {
+        ++bit;
+    }
+    for (; bit < BIT_COUNT; ++bit) {
+        const bool is_key_bit = (key >> bit) & 1;
+        if (slices_[bit].IsEmpty()) {
+            if (is_key_bit) {
+                documents = documents_;
+            }
+        }
+        else if (slices_[bit].GetSize() == documents_.GetSize()) {
+            if (!is_key_bit) {
+                documents = {};
+            }
+        }
+        else if (is_key_bit) {
+            Bitmap excluded = slices_[bit];
+            excluded -= documents;
+            documents = documents_;
+            documents -= excluded;
+        }
+        else {
+            documents -= slices_[bit];
+        }
+    }
+    return documents;
+}
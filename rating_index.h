@@ -0,0 +1,27 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+#include "bitmap.h"
+
+// Битово-срезовый индекс рейтингов: рейтинг со смещённым знаковым битом хранится
+// по битам, i-й срез содержит документы, у которых i-й бит равен 1.
+// Диапазон рейтингов любой ширины вычисляется за BIT_COUNT шагов по срезам
+class RatingIndex {
+public:
+    void Add(int document_id, int rating);
+    void Remove(int document_id, int rating);
+    // Документы с рейтингом из [min_rating, max_rating]
+    Bitmap Find(int min_rating, int max_rating) const;
+
+private:
+    static const int BIT_COUNT = 32;
+
+private:
+    static uint32_t ToKey(int rating);
+    Bitmap FindLessOrEqual(uint32_t key) const;
+
+private:
+    std::array<Bitmap, BIT_COUNT> slices_;
+    Bitmap documents_;
+};
@@ -0,0 +1,54 @@
+#include "ratings.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+// Рейтинги обрабатываются блоками по LANE_COUNT: у каждой дорожки своя 64-битная сумма,
+// минимум и максимум, а цикл по дорожкам без ветвлений компилятор векторизует.
+// 64-битная сумма не переполняется даже на очень длинных массивах
+RatingStats ComputeRatingStats(RatingsView ratings) {
+    static const size_t LANE_COUNT = 8;
+
+    RatingStats stats;
+    if (ratings.empty()) {
+        return stats;
+    }
+
+    const int* data = ratings.data();
+    const size_t size = ratings.size();
+
+    std::array<int64_t, LANE_COUNT> sums{};
+    std::array<int, LANE_COUNT> mins;
+    std::array<int, LANE_COUNT> maxs;
+    mins.fill(data[0]);
+    maxs.fill(data[0]);
+
+    size_t i = 0;
+    for (; i + LANE_COUNT <= size; i += LANE_COUNT) {
+        for (size_t lane = 0; lane < LANE_COUNT; ++lane) {
+            sums[lane] += data[i + lane];
+        }
+        for (size_t lane = 0; lane < LANE_COUNT; ++lane) {
+            mins[lane] = data[i + lane] < mins[lane] ? data[i + lane] : mins[lane];
+        }
+        for (size_t lane = 0; lane < LANE_COUNT; ++lane) {
+            maxs[lane] = data[i + lane] > maxs[lane] ? data[i + lane] : maxs[lane];
+        }
+    }
+    for (size_t lane = 0; i < size; ++i, ++lane) {
+        sums[lane] += data[i];
+        mins[lane] = std::min(mins[lane], data[i]);
+        maxs[lane] = std::max(maxs[lane], data[i]);
+    }
+
+    int64_t sum = 0;
+    for (const int64_t lane_sum : sums) {
+        sum += lane_sum;
+    }
+    stats.count = size;
+    stats.mean = static_cast<int>(sum / static_cast<int64_t>(size));
+    stats.min = *std::min_element(mins.begin(), mins.end());
+    stats.max = *std::max_element(maxs.begin(), maxs.end());
+    return stats;
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <vector>
+
+// Невладеющее представление массива рейтингов: позволяет передать в AddDocument
+// вектор, список инициализации или участок чужого буфера без копирования
+class RatingsView {
+public:
+    RatingsView() = default;
+
+    RatingsView(const int* data, size_t size)
+        : data_(data)
+        , size_(size) {
+    }
+
+    RatingsView(const std::vector<int>& ratings)
+        : data_(ratings.data())
+        , size_(ratings.size()) {
+    }
+
+    // Список живёт до конца полного выражения, поэтому представление
+    // можно передавать только непосредственно в вызов: AddDocument(..., { 1, 2 })
+    RatingsView(std::initializer_list<int> ratings)
+        : data_(std::data(ratings))
+        , size_(ratings.size()) {
+    }
+
+public:
+    const int* begin() const {
+        return data_;
+    }
+
+    const int* end() const {
+        return data_ + size_;
+    }
+
+    const int* data() const {
+        return data_;
+    }
+
+    size_t size() const {
+        return size_;
+    }
+
+    bool empty() const {
+        return size_ == 0;
+    }
+
+private:
+    const int* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// Для документа без рейтингов все поля равны нулю
+struct RatingStats {
+    size_t count = 0;
+    int mean = 0;
+    int min = 0;
+    int max = 0;
+};
+
+RatingStats ComputeRatingStats(RatingsView ratings);
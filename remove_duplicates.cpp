@@ -20,6 +20,6 @@ void RemoveDuplicates(SearchServer& search_server) {
 
     for (const int document_id : ids_to_remove) {
         std::cout << "Found duplicate document id " << document_id << std::endl;
-        search_server.RemoveDocument(document_id);
     }
+    search_server.RemoveDocuments(std::execution::par, ids_to_remove);
 }
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+struct CorpusStatistics {
+    size_t document_count = 0;
+    double average_document_length = 0.0;
+};
+
+// Ранжирующие функции для FindTopDocuments. Вес слова вычисляется один раз на запрос,
+// а Score - для блока вхождений слова сразу, поэтому должен быть простой арифметикой
+// над Lane без ветвлений: компилятор векторизует его по всему блоку.
+// term_freq - доля слова среди слов документа, document_length - число слов документа.
+// MaxScore - верхняя оценка Score по всем документам для слова с весом word_weight, доля которого
+// в документах не превышает max_term_freq. По ней поиск отбрасывает документы, которые не могут
+// попасть на запрошенную страницу
+
+struct TfIdfScorer {
+    using Lane = double;
+    static constexpr bool NEEDS_DOCUMENT_LENGTH = false;
+
+    double ComputeWordWeight(size_t document_freq, const CorpusStatistics& corpus) const {
+        return std::log(corpus.document_count * 1.0 / document_freq);
+    }
+
+    Lane Score(Lane term_freq, Lane, Lane word_weight, const CorpusStatistics&) const {
+        return term_freq * word_weight;
+    }
+
+    double MaxScore(Lane max_term_freq, Lane word_weight) const {
+        return max_term_freq * word_weight;
+    }
+};
+
+struct Bm25Scorer {
+    using Lane = float;
+    static constexpr bool NEEDS_DOCUMENT_LENGTH = true;
+
+    double ComputeWordWeight(size_t document_freq, const CorpusStatistics& corpus) const {
+        return std::log(1.0 + (corpus.document_count - document_freq + 0.5) / (document_freq + 0.5));
+    }
+
+    Lane Score(Lane term_freq, Lane document_length, Lane word_weight, const CorpusStatistics& corpus) const {
+        const Lane term_count = term_freq * document_length;
+        const Lane length_norm = k1 * (1 - b + b * document_length / static_cast<Lane>(corpus.average_document_length));
+        return word_weight * term_count * (k1 + 1) / (term_count + length_norm);
+    }
+
+    // Дробь term_count / (term_count + length_norm) меньше 1, запас покрывает округление во float
+    double MaxScore(Lane, Lane word_weight) const {
+        return word_weight * (k1 + 1) * (1.0 + 8 * std::numeric_limits<Lane>::epsilon());
+    }
+
+    Lane k1 = 1.2f;
+    Lane b = 0.75f;
+};
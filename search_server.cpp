@@ -1,5 +1,7 @@
 #include "search_server.h"
 
+#include <charconv>
+
 SearchServer::SearchServer(std::string_view stop_words_text)
     : SearchServer(SplitIntoWords(stop_words_text)) {
 }
@@ -20,13 +22,22 @@ std::set<int>::const_iterator SearchServer::end() const {
     return document_ids_.end();
 }
 
-const std::map<std::string_view, double>& SearchServer::GetWordFrequencies(int document_id) const {
-    static const std::map<std::string_view, double> empty_map;
-    if (document_to_word_freqs_.count(document_id)) {
-        return document_to_word_freqs_.at(document_id);
-    }
+ForwardIndex::WordFrequencies SearchServer::GetWordFrequencies(int document_id) const {
+    return forward_index_.Get(document_id);
+}
+
+std::map<std::string_view, double> SearchServer::CopyWordFrequencies(int document_id) const {
+    const ForwardIndex::WordFrequencies word_freqs = forward_index_.Get(document_id);
+    return { word_freqs.begin(), word_freqs.end() };
+}
 
-    return empty_map;
+SearchServer::MemoryReport SearchServer::GetMemoryReport() const {
+    MemoryReport report;
+    report.forward_index = forward_index_.GetMemoryUsage();
+    report.forward_index_entries = forward_index_.GetEntryCount();
+    report.dictionary = words_.GetMemoryUsage();
+    report.document_texts = document_store_.GetMemoryUsage();
+    return report;
 }
 
 void SearchServer::RemoveDocument(int document_id) {
@@ -34,72 +45,139 @@ void SearchServer::RemoveDocument(int document_id) {
 }
 
 void SearchServer::RemoveDocument(const std::execution::sequenced_policy&, int document_id) {
-    const auto document_found_it = document_ids_.find(document_id);
+    RemoveDocuments(std::execution::seq, { document_id });
+}
 
-    if (document_found_it == document_ids_.end()) {
-        return;
-    }
+void SearchServer::RemoveDocument(const std::execution::parallel_policy&, int document_id) {
+    RemoveDocuments(std::execution::par, { document_id });
+}
 
-    document_ids_.erase(document_found_it);
-    documents_.erase(document_id);
-    
-    for (auto& [word, _] : document_to_word_freqs_.at(document_id)) {
-        word_to_document_freqs_.at(word).erase(document_id);
+void SearchServer::RemoveDocuments(const std::vector<int>& document_ids) {
+    RemoveDocuments(std::execution::seq, document_ids);
+}
+
+void SearchServer::SetStopWords(std::string_view text) {
+    for (std::string_view word : SplitIntoWords(text)) {
+        stop_words_.insert(static_cast<std::string>(word));
     }
+}
 
-    document_to_word_freqs_.erase(document_id);
+void SearchServer::SetTextCompression(TextCompression compression) {
+    document_store_.SetCompression(compression);
 }
 
-void SearchServer::RemoveDocument(const std::execution::parallel_policy&, int document_id) {
-    const auto document_found_it = document_ids_.find(document_id);
+void SearchServer::SetPositionalIndex(bool enabled) {
+    if (enabled != is_positional_index_enabled_ && !documents_.empty()) {
+        using namespace std::string_literals;
+        throw std::logic_error("Positional index must be configured before adding documents"s);
+    }
+    is_positional_index_enabled_ = enabled;
+}
 
-    if (document_found_it == document_ids_.end()) {
+void SearchServer::SetFuzzySearch(int max_edit_distance) {
+    if (max_edit_distance < 0 || max_edit_distance > 2) {
+        using namespace std::string_literals;
+        throw std::invalid_argument("Edit distance must be between 0 and 2"s);
+    }
+    if (max_edit_distance == 0) {
+        deletion_index_.reset();
         return;
     }
 
-    document_ids_.erase(document_found_it);
-    documents_.erase(document_id);
-    
-    const auto& word_freqs = document_to_word_freqs_.at(document_id);
-
-    for_each(std::execution::par,
-        word_freqs.begin(), word_freqs.end(),
-        [this, document_id](const auto& item) {
-            word_to_document_freqs_.at(item.first).erase(document_id);
-        });
+    deletion_index_.emplace(max_edit_distance);
+    for (const auto& [word, document_freqs] : word_to_document_freqs_) {
+        deletion_index_->Add(word);
+    }
+}
 
-    document_to_word_freqs_.erase(document_id);
+std::string SearchServer::GetDocumentText(int document_id) const {
+    if (!document_ids_.count(document_id)) {
+        using namespace std::string_literals;
+        throw std::out_of_range("out of range"s);
+    }
+    return document_store_.Get(document_id);
 }
 
-void SearchServer::SetStopWords(std::string_view text) {
-    for (std::string_view word : SplitIntoWords(text)) {
-        stop_words_.insert(static_cast<std::string>(word));
+std::vector<std::string> SearchServer::GetDocumentTexts(const std::vector<Document>& documents) const {
+    std::vector<int> document_ids;
+    document_ids.reserve(documents.size());
+    for (const Document& document : documents) {
+        document_ids.push_back(document.id);
     }
+    return document_store_.Get(document_ids);
+}
+
+SearchServer::TokenizedDocument::TokenizedDocument(std::string_view text, std::vector<std::string_view> words)
+    : text_(text)
+    , words_(std::move(words)) {
+}
+
+SearchServer::TokenizedDocument SearchServer::TokenizeDocument(std::string_view document) const {
+    return { document, SplitIntoWordsNoStop(document) };
 }
 
 void SearchServer::AddDocument(int document_id, std::string_view document, DocumentStatus status,
-    const std::vector<int>& ratings) {
+    RatingsView ratings) {
     if ((document_id < 0) || (documents_.count(document_id) > 0)) {
         using namespace std::string_literals;
         throw std::invalid_argument("Invalid document ID"s);
     }
 
-    const std::vector<std::string_view> words = SplitIntoWordsNoStop(document);
-    const double inv_word_count = 1.0 / words.size();
+    AddDocument(document_id, TokenizeDocument(document), status, ratings);
+}
 
-    for (std::string_view word : words) {
-        auto it = words_.insert(static_cast<std::string>(word));
-        word_to_document_freqs_[*it.first][document_id] += inv_word_count;
-        document_to_word_freqs_[document_id][*it.first] += inv_word_count;
+void SearchServer::AddDocument(int document_id, const TokenizedDocument& document, DocumentStatus status,
+    RatingsView ratings) {
+    if ((document_id < 0) || (documents_.count(document_id) > 0)) {
+        using namespace std::string_literals;
+        throw std::invalid_argument("Invalid document ID"s);
+    }
+
+    const std::vector<std::string_view>& words = document.words_;
+    const double inv_word_count = 1.0 / words.size();
+    std::map<std::string_view, double> word_freqs;
+
+    for (size_t position = 0; position < words.size(); ++position) {
+        auto word_it = word_to_document_freqs_.find(words[position]);
+        if (word_it == word_to_document_freqs_.end()) {
+            // Слово, удалённое из словаря вместе с последним документом, уже лежит в арене,
+            // и прямой индекс хранит его представление: вернувшееся слово не копируется заново
+            std::string_view stored_word = forward_index_.FindWord(words[position]);
+            if (stored_word.empty()) {
+                stored_word = words_.Store(words[position]);
+            }
+            word_it = word_to_document_freqs_.emplace(stored_word, std::map<int, Posting>{}).first;
+            if (deletion_index_) {
+                deletion_index_->Add(word_it->first);
+            }
+        }
+        Posting& posting = word_it->second[document_id];
+        posting.term_freq += inv_word_count;
+        posting.document_length = static_cast<int>(words.size());
+        word_freqs[word_it->first] += inv_word_count;
+        if (is_positional_index_enabled_) {
+            word_to_document_positions_[word_it->first][document_id].Add(static_cast<uint32_t>(position));
+        }
     }
    
-    documents_.emplace(document_id,
+    for (const auto [word, term_freq] : word_freqs) {
+        double& max_term_freq = word_to_max_term_freq_[word];
+        max_term_freq = std::max(max_term_freq, term_freq);
+    }
+
+    const auto document_it = documents_.emplace(document_id,
         DocumentData{
-            ComputeAverageRating(ratings),
-            status
-        });
+            ComputeRatingStats(ratings),
+            status,
+            static_cast<int>(words.size())
+        }).first;
+    total_document_length_ += words.size();
+    status_to_documents_[status].Add(document_id);
+    rating_index_.Add(document_id, document_it->second.ratings.mean);
 
     document_ids_.insert(document_id);
+    forward_index_.Add(document_id, word_freqs);
+    document_store_.Add(document_id, document.text_);
 }
 
 std::vector<Document> SearchServer::FindTopDocuments(std::string_view raw_query,
@@ -107,29 +185,47 @@ std::vector<Document> SearchServer::FindTopDocuments(std::string_view raw_query,
     return FindTopDocuments(std::execution::seq, raw_query, search_status);
 }
 
+std::vector<Document> SearchServer::FindTopDocuments(std::string_view raw_query,
+    size_t page, size_t page_size) const {
+    return FindTopDocuments(std::execution::seq, raw_query, DocumentStatus::ACTUAL, page, page_size);
+}
+
+std::vector<Document> SearchServer::FindTopDocuments(std::string_view raw_query, const SearchOptions& options) const {
+    return FindTopDocuments(std::execution::seq, raw_query, options);
+}
+
 std::tuple<std::vector<std::string_view>, DocumentStatus>
 SearchServer::MatchDocument(std::string_view raw_query, int document_id) const {
     return MatchDocument(std::execution::seq, raw_query, document_id);
 }
 
-int SearchServer::ComputeAverageRating(const std::vector<int>& ratings) {
-    int rating_sum = 0;
-    for (const int rating : ratings) {
-        rating_sum += rating;
+QueryPlan SearchServer::Explain(std::string_view raw_query) const {
+    return Explain(std::execution::seq, raw_query);
+}
+
+bool SearchServer::CompareDocuments(const Document& lhs, const Document& rhs) {
+    if (std::abs(lhs.relevance - rhs.relevance) < RELEVANCE_EPSILON) {
+        if (lhs.rating == rhs.rating) {
+            return lhs.id < rhs.id;
+        }
+        return lhs.rating > rhs.rating;
+    }
+    else {
+        return lhs.relevance > rhs.relevance;
     }
-    return rating_sum / static_cast<int>(ratings.size());
 }
 
 bool SearchServer::IsStopWord(std::string_view word) const {
     return stop_words_.count(word) > 0;
 }
 
-double SearchServer::ComputeWordInverseDocumentFreq(std::string_view word) const {
-    assert(word_to_document_freqs_.count(word) > 0
-        && "Word must be contained in search query");
-    int word_size = word_to_document_freqs_.at(word).size();
-    assert(word_size != 0 && "Division by zero");
-    return log(GetDocumentCount() * 1.0 / word_size);
+CorpusStatistics SearchServer::GetCorpusStatistics() const {
+    CorpusStatistics corpus;
+    corpus.document_count = documents_.size();
+    if (!documents_.empty()) {
+        corpus.average_document_length = total_document_length_ * 1.0 / documents_.size();
+    }
+    return corpus;
 }
 
 bool SearchServer::IsValidWord(std::string_view word) {
@@ -158,8 +254,377 @@ SearchServer::Query SearchServer::ParseQuery(std::string_view text) const {
     return ParseQuery(std::execution::seq, text);
 }
 
+size_t SearchServer::ParsePhrase(const std::vector<std::string_view>& words, size_t first,
+    Query& query) const {
+    using namespace std::string_literals;
+    Phrase phrase;
+    bool is_closed = false;
+    size_t i = first;
+    for (; i < words.size() && !is_closed; ++i) {
+        std::string_view word = words[i];
+        if (i == first) {
+            word.remove_prefix(1);
+        }
+
+        const size_t quote = word.find('"');
+        if (quote != word.npos) {
+            std::string_view suffix = word.substr(quote + 1);
+            word = word.substr(0, quote);
+            is_closed = true;
+            if (!suffix.empty()) {
+                if (suffix.size() < 2 || suffix[0] != '~'
+                    || !std::all_of(suffix.begin() + 1, suffix.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+                    throw std::invalid_argument("Error in query"s);
+                }
+                const auto [end, error] = std::from_chars(suffix.data() + 1, suffix.data() + suffix.size(), phrase.slop);
+                if (error != std::errc{} || end != suffix.data() + suffix.size()) {
+                    throw std::invalid_argument("Error in query"s);
+                }
+            }
+        }
+
+        if (word.empty()) {
+            continue;
+        }
+        const QueryWord query_word = ParseQueryWord(word);
+        if (query_word.is_minus) {
+            throw std::invalid_argument("Error in query"s);
+        }
+        if (query_word.is_wildcard) {
+            throw std::invalid_argument("Wildcard is not allowed in a phrase"s);
+        }
+        if (!query_word.is_stop) {
+            phrase.words.push_back(query_word.data);
+            AddPlusWord(query, query_word.data, 0);
+        }
+    }
+
+    if (!is_closed) {
+        throw std::invalid_argument("Error in query"s);
+    }
+    if (phrase.words.size() > 1) {
+        if (!is_positional_index_enabled_) {
+            throw std::invalid_argument("Phrase queries require positional index"s);
+        }
+        query.phrases.push_back(std::move(phrase));
+    }
+    return i - 1;
+}
+
+bool SearchServer::MatchesPhrase(int document_id, const Phrase& phrase) const {
+    std::vector<std::vector<uint32_t>> positions;
+    positions.reserve(phrase.words.size());
+    for (std::string_view word : phrase.words) {
+        const auto word_it = word_to_document_positions_.find(word);
+        if (word_it == word_to_document_positions_.end()) {
+            return false;
+        }
+        const auto document_it = word_it->second.find(document_id);
+        if (document_it == word_it->second.end()) {
+            return false;
+        }
+        positions.push_back(document_it->second.Decode());
+    }
+
+    if (phrase.slop == 0) {
+        return std::any_of(positions[0].begin(), positions[0].end(),
+            [&positions](uint32_t start) {
+                for (size_t i = 1; i < positions.size(); ++i) {
+                    if (!std::binary_search(positions[i].begin(), positions[i].end(), start + i)) {
+                        return false;
+                    }
+                }
+                return true;
+            });
+    }
+
+    // Ищем наименьшее окно, в котором каждое слово встречается столько раз, сколько во фразе:
+    // повторяющимся словам фразы должны соответствовать разные позиции документа
+    std::vector<size_t> required_counts(positions.size(), 0);
+    std::vector<std::pair<uint32_t, size_t>> word_positions;
+    size_t distinct_word_count = 0;
+    for (size_t i = 0; i < phrase.words.size(); ++i) {
+        const size_t first = std::find(phrase.words.begin(), phrase.words.end(), phrase.words[i]) - phrase.words.begin();
+        if (required_counts[first]++ == 0) {
+            ++distinct_word_count;
+            for (const uint32_t position : positions[first]) {
+                word_positions.push_back({ position, first });
+            }
+        }
+    }
+    std::sort(word_positions.begin(), word_positions.end());
+
+    const uint64_t max_span = phrase.words.size() - 1 + static_cast<uint64_t>(phrase.slop);
+    std::vector<size_t> window_counts(positions.size(), 0);
+    size_t satisfied_word_count = 0;
+    size_t left = 0;
+    for (const auto& [position, word_index] : word_positions) {
+        if (++window_counts[word_index] == required_counts[word_index]) {
+            ++satisfied_word_count;
+        }
+        while (satisfied_word_count == distinct_word_count) {
+            if (position - word_positions[left].first <= max_span) {
+                return true;
+            }
+            const size_t left_word_index = word_positions[left].second;
+            if (window_counts[left_word_index]-- == required_counts[left_word_index]) {
+                --satisfied_word_count;
+            }
+            ++left;
+        }
+    }
+    return false;
+}
+
+bool SearchServer::MatchesPhrases(int document_id, const Query& query) const {
+    return std::all_of(query.phrases.begin(), query.phrases.end(),
+        [this, document_id](const Phrase& phrase) {
+            return MatchesPhrase(document_id, phrase);
+        });
+}
+
+void SearchServer::ErasePhraseMismatches(std::map<int, double>& document_to_relevance,
+    const Query& query) const {
+    if (query.phrases.empty()) {
+        return;
+    }
+    for (auto it = document_to_relevance.begin(); it != document_to_relevance.end();) {
+        if (MatchesPhrases(it->first, query)) {
+            ++it;
+        }
+        else {
+            it = document_to_relevance.erase(it);
+        }
+    }
+}
+
+// Словарь упорядочен, поэтому слова с общим префиксом занимают непрерывный диапазон.
+// Обход диапазона ограничен: просматривается не более MAX_WILDCARD_SCAN слов и берётся
+// не более MAX_WILDCARD_EXPANSION подходящих в порядке словаря. Минус-шаблон должен исключить
+// все подходящие слова, поэтому если его раскрытие не помещается в эти пределы, запрос отклоняется
+std::vector<std::string_view> SearchServer::ExpandWildcard(std::string_view pattern, bool is_minus) const {
+    const std::string_view prefix = pattern.substr(0, pattern.find_first_of("*?"));
+    std::vector<std::string_view> words;
+    size_t scanned_count = 0;
+    for (auto it = word_to_document_freqs_.lower_bound(prefix);
+        it != word_to_document_freqs_.end() && it->first.substr(0, prefix.size()) == prefix; ++it) {
+        const bool is_limit_reached = scanned_count == MAX_WILDCARD_SCAN
+            || (words.size() == MAX_WILDCARD_EXPANSION && !it->second.empty() && MatchWildcard(pattern, it->first));
+        if (is_limit_reached) {
+            if (is_minus) {
+                using namespace std::string_literals;
+                throw std::invalid_argument("Minus wildcard matches too many words"s);
+            }
+            break;
+        }
+        ++scanned_count;
+        if (!it->second.empty() && MatchWildcard(pattern, it->first)) {
+            words.push_back(it->first);
+        }
+    }
+    return words;
+}
+
+void SearchServer::AddPlusWord(Query& query, std::string_view word, int max_edit_distance) const {
+    query.plus_words[word] = 1.0;
+    if (max_edit_distance == 0) {
+        return;
+    }
+    if (max_edit_distance < 0 || !deletion_index_ || deletion_index_->GetMaxDistance() < max_edit_distance) {
+        using namespace std::string_literals;
+        throw std::invalid_argument("Fuzzy search is not enabled for this edit distance"s);
+    }
+
+    for (const auto& [similar_word, distance] : deletion_index_->Lookup(word)) {
+        const auto word_it = word_to_document_freqs_.find(similar_word);
+        if (distance == 0 || distance > max_edit_distance
+            || word_it == word_to_document_freqs_.end() || word_it->second.empty()) {
+            continue;
+        }
+        double& weight = query.plus_words[similar_word];
+        weight = std::max(weight, std::pow(FUZZY_MATCH_DISCOUNT, distance));
+    }
+}
+
+// Стоимость стратегий оценивается числом обращений к вхождениям, умноженным на цену обращения:
+// накопитель платит за вставку в дерево результатов, слияние - за выбор среди курсоров плюс-слов,
+// пересечение - за поиск кандидата в дереве каждого слова.
+// Заданная strategy заменяет выбор по стоимости, параллельным при этом может остаться только накопитель
+QueryPlan SearchServer::PlanQuery(const Query& query, bool is_parallel_allowed,
+    std::optional<QueryStrategy> strategy) const {
+    if (strategy == QueryStrategy::INTERSECTION && query.phrases.empty()) {
+        using namespace std::string_literals;
+        throw std::invalid_argument("intersection strategy requires a phrase"s);
+    }
+
+    const auto make_term = [this](std::string_view word, double weight) {
+        PlannedTerm term;
+        term.word = word;
+        term.weight = weight;
+        const auto word_it = word_to_document_freqs_.find(word);
+        if (word_it != word_to_document_freqs_.end()) {
+            term.document_freq = word_it->second.size();
+            term.max_term_freq = word_to_max_term_freq_.at(word);
+        }
+        if (term.document_freq > 0) {
+            term.inverse_document_freq = std::log(documents_.size() * 1.0 / term.document_freq);
+        }
+        return term;
+    };
+    const auto is_rarer = [](const PlannedTerm& lhs, const PlannedTerm& rhs) {
+        return lhs.document_freq < rhs.document_freq;
+    };
+    const auto log2_ceil = [](size_t value) {
+        size_t result = 1;
+        for (; value > 1; value >>= 1) {
+            ++result;
+        }
+        return result;
+    };
+
+    QueryPlan plan;
+    size_t plus_posting_count = 0;
+    size_t max_document_freq = 0;
+    for (const auto [word, weight] : query.plus_words) {
+        plan.plus_terms.push_back(make_term(word, weight));
+        plus_posting_count += plan.plus_terms.back().document_freq;
+        max_document_freq = std::max(max_document_freq, plan.plus_terms.back().document_freq);
+    }
+    size_t minus_posting_count = 0;
+    for (std::string_view word : query.minus_words) {
+        plan.minus_terms.push_back(make_term(word, 1.0));
+        minus_posting_count += plan.minus_terms.back().document_freq;
+    }
+    std::stable_sort(plan.plus_terms.begin(), plan.plus_terms.end(), is_rarer);
+    std::stable_sort(plan.minus_terms.begin(), plan.minus_terms.end(), is_rarer);
+    plan.phrase_count = query.phrases.size();
+
+    const size_t matched_term_count = std::count_if(plan.plus_terms.begin(), plan.plus_terms.end(),
+        [](const PlannedTerm& term) {
+            return term.document_freq > 0;
+        });
+    plan.accumulator_cost = (plus_posting_count + minus_posting_count)
+        * log2_ceil(std::min(plus_posting_count, documents_.size()));
+    plan.document_at_a_time_cost = plus_posting_count * std::max<size_t>(matched_term_count, 1) + minus_posting_count;
+
+    plan.strategy = QueryStrategy::ACCUMULATOR;
+    plan.estimated_cost = plan.accumulator_cost;
+    if (plan.document_at_a_time_cost < plan.estimated_cost) {
+        plan.strategy = QueryStrategy::DOCUMENT_AT_A_TIME;
+        plan.estimated_cost = plan.document_at_a_time_cost;
+    }
+
+    if (!query.phrases.empty()) {
+        size_t candidate_count = std::numeric_limits<size_t>::max();
+        size_t phrase_word_count = 0;
+        for (const Phrase& phrase : query.phrases) {
+            for (std::string_view word : phrase.words) {
+                const auto word_it = word_to_document_freqs_.find(word);
+                candidate_count = std::min(candidate_count,
+                    word_it == word_to_document_freqs_.end() ? 0 : word_it->second.size());
+            }
+            phrase_word_count += phrase.words.size();
+        }
+        plan.intersection_cost = candidate_count
+            * (matched_term_count + plan.minus_terms.size() + phrase_word_count) * log2_ceil(max_document_freq);
+        if (plan.intersection_cost < plan.estimated_cost) {
+            plan.strategy = QueryStrategy::INTERSECTION;
+            plan.estimated_cost = plan.intersection_cost;
+        }
+    }
+
+    // Параллельный накопитель распределяет слова по потокам, поэтому выигрыш ограничен числом слов
+    if (is_parallel_allowed && plan.estimated_cost >= PARALLEL_QUERY_COST_THRESHOLD) {
+        const size_t thread_count = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+        const size_t parallel_cost = plan.accumulator_cost / std::clamp<size_t>(matched_term_count, 1, thread_count);
+        if (parallel_cost < plan.estimated_cost) {
+            plan.strategy = QueryStrategy::ACCUMULATOR;
+            plan.is_parallel = true;
+            plan.estimated_cost = parallel_cost;
+        }
+    }
+
+    if (strategy && *strategy != plan.strategy) {
+        plan.strategy = *strategy;
+        plan.is_parallel = false;
+        switch (*strategy) {
+        case QueryStrategy::ACCUMULATOR:
+            plan.estimated_cost = plan.accumulator_cost;
+            break;
+        case QueryStrategy::DOCUMENT_AT_A_TIME:
+            plan.estimated_cost = plan.document_at_a_time_cost;
+            break;
+        case QueryStrategy::INTERSECTION:
+            plan.estimated_cost = plan.intersection_cost;
+            break;
+        }
+    }
+    return plan;
+}
+
+const Bitmap& SearchServer::GetStatusDocuments(DocumentStatus status) const {
+    static const Bitmap empty_documents;
+    const auto status_it = status_to_documents_.find(status);
+    return status_it == status_to_documents_.end() ? empty_documents : status_it->second;
+}
+
+// Выбирает документы из диапазона рейтингов по срезам индекса и пересекает результат с картой статуса.
+// Карта статуса не копируется, временная карта строится только по документам из диапазона
+Bitmap SearchServer::BuildFilterBitmap(const DocumentFilter& filter) const {
+    Bitmap documents = rating_index_.Find(filter.min_rating, filter.max_rating);
+    if (filter.status) {
+        documents &= GetStatusDocuments(*filter.status);
+    }
+    return documents;
+}
+
+void SearchServer::RemoveFromFilterIndex(int document_id) {
+    const DocumentData& document_data = documents_.at(document_id);
+    status_to_documents_.at(document_data.status).Remove(document_id);
+    rating_index_.Remove(document_id, document_data.ratings.mean);
+}
+
+// Убирает документы из всех структур, кроме списков вхождений,
+// и возвращает для каждого их слова удалённые документы
+std::map<std::string_view, std::vector<int>> SearchServer::UnlinkDocuments(const std::vector<int>& document_ids) {
+    std::map<std::string_view, std::vector<int>> word_to_removed_documents;
+    for (const int document_id : document_ids) {
+        // Повторный id уже удалён из document_ids_ и пропускается здесь
+        if (document_ids_.count(document_id) == 0) {
+            continue;
+        }
+
+        document_ids_.erase(document_id);
+        RemoveFromFilterIndex(document_id);
+        total_document_length_ -= documents_.at(document_id).length;
+        documents_.erase(document_id);
+
+        for (const auto [word, _] : forward_index_.Get(document_id)) {
+            word_to_removed_documents[word].push_back(document_id);
+        }
+        forward_index_.Remove(document_id);
+        document_store_.Remove(document_id);
+    }
+
+    return word_to_removed_documents;
+}
+
+void SearchServer::EraseWordIfUnused(std::string_view word) {
+    const auto word_it = word_to_document_freqs_.find(word);
+    if (word_it == word_to_document_freqs_.end() || !word_it->second.empty()) {
+        return;
+    }
+
+    if (deletion_index_) {
+        deletion_index_->Remove(word);
+    }
+    word_to_document_positions_.erase(word);
+    word_to_max_term_freq_.erase(word);
+    word_to_document_freqs_.erase(word_it);
+}
+
 void AddDocument(SearchServer& search_server, int document_id, std::string_view document, DocumentStatus status,
-    const std::vector<int>& ratings) {
+    RatingsView ratings) {
     try {
         search_server.AddDocument(document_id, document, status, ratings);
     }
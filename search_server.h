@@ -1,20 +1,60 @@
 #pragma once
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cmath>
 #include <execution>
+#include <functional>
+#include <limits>
 #include <map>
+#include <optional>
+#include <queue>
 #include <set>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
+#include "bitmap.h"
 #include "concurrent_map.h"
+#include "deletion_index.h"
 #include "document.h"
+#include "document_filters.h"
+#include "document_store.h"
+#include "forward_index.h"
 #include "string_processing.h"
 #include "log_duration.h"
+#include "position_list.h"
+#include "query_plan.h"
+#include "rating_index.h"
+#include "ratings.h"
+#include "scorers.h"
+#include "string_arena.h"
 
 class SearchServer {
+public:
+    // Приблизительный объём памяти основных структур, в байтах
+    struct MemoryReport {
+        size_t forward_index = 0;
+        size_t forward_index_entries = 0;
+        size_t dictionary = 0;
+        size_t document_texts = 0;
+    };
+
+    // Документ, заранее разобранный на слова. Разбор не меняет сервер,
+    // поэтому несколько документов можно разбирать параллельно.
+    // Создаётся только TokenizeDocument, так что AddDocument получает проверенные слова
+    class TokenizedDocument {
+    private:
+        friend class SearchServer;
+        TokenizedDocument(std::string_view text, std::vector<std::string_view> words);
+
+    private:
+        std::string_view text_;
+        std::vector<std::string_view> words_;
+    };
+
 public:
     explicit SearchServer(std::string_view stop_words_text);
     explicit SearchServer(const std::string& stop_words_text);
@@ -28,17 +68,81 @@ public:
     std::set<int>::const_iterator begin() const;
     std::set<int>::const_iterator end() const;
     int GetDocumentCount() const;
-    const std::map<std::string_view, double>& GetWordFrequencies(int document_id) const;
+    // Представление ссылается на общие массивы прямого индекса и недействительно после
+    // следующего AddDocument или удаления документа. Частоты, нужные дольше, копируются
+    // CopyWordFrequencies. Для неизвестного id оба метода возвращают пустой результат
+    ForwardIndex::WordFrequencies GetWordFrequencies(int document_id) const;
+    std::map<std::string_view, double> CopyWordFrequencies(int document_id) const;
+    MemoryReport GetMemoryReport() const;
     void RemoveDocument(int document_id);
     void RemoveDocument(const std::execution::sequenced_policy&, int document_id);
     void RemoveDocument(const std::execution::parallel_policy&, int document_id);
+    void RemoveDocuments(const std::vector<int>& document_ids);
     void SetStopWords(std::string_view text);
+    void SetTextCompression(TextCompression compression);
+    void SetPositionalIndex(bool enabled);
+    // Строит индекс похожих слов; сам нечёткий поиск включается в запросе через SearchOptions
+    void SetFuzzySearch(int max_edit_distance);
+    std::string GetDocumentText(int document_id) const;
+    std::vector<std::string> GetDocumentTexts(const std::vector<Document>& documents) const;
+    TokenizedDocument TokenizeDocument(std::string_view document) const;
     void AddDocument(int document_id, std::string_view document, DocumentStatus status,
-        const std::vector<int>& ratings);
+        RatingsView ratings);
+    void AddDocument(int document_id, const TokenizedDocument& document, DocumentStatus status,
+        RatingsView ratings);
     std::vector<Document> FindTopDocuments(std::string_view raw_query,
         const DocumentStatus search_status = DocumentStatus::ACTUAL) const;
+    std::vector<Document> FindTopDocuments(std::string_view raw_query, size_t page, size_t page_size) const;
+    std::vector<Document> FindTopDocuments(std::string_view raw_query, const SearchOptions& options) const;
     std::tuple<std::vector<std::string_view>, DocumentStatus>
         MatchDocument(std::string_view raw_query, int document_id) const;
+    // План, по которому FindTopDocuments(raw_query) выполнит запрос
+    QueryPlan Explain(std::string_view raw_query) const;
+
+    // План, по которому FindTopDocuments с той же политикой и параметрами выполнит запрос
+    template <typename ExecutionPolicy>
+    QueryPlan Explain(ExecutionPolicy&& policy, std::string_view raw_query, const SearchOptions& options = {}) const {
+        return PlanQuery(ParseQuery(policy, raw_query, options.max_edit_distance), IS_PARALLEL_POLICY<ExecutionPolicy>,
+            options.strategy);
+    }
+
+    // Документы сразу исключаются из выдачи, затем списки вхождений затронутых слов
+    // очищаются за один проход, по одному слову на задачу. Слова без вхождений удаляются из словаря
+    template <typename ExecutionPolicy>
+    void RemoveDocuments(ExecutionPolicy&& policy, const std::vector<int>& document_ids) {
+        struct WordPostings {
+            std::map<int, Posting>* document_freqs;
+            std::map<int, PositionList>* document_positions;
+            const std::vector<int>* removed_document_ids;
+        };
+
+        const std::map<std::string_view, std::vector<int>> word_to_removed_documents =
+            UnlinkDocuments(document_ids);
+
+        std::vector<WordPostings> postings;
+        postings.reserve(word_to_removed_documents.size());
+        for (const auto& [word, removed_document_ids] : word_to_removed_documents) {
+            postings.push_back({
+                &word_to_document_freqs_.at(word),
+                is_positional_index_enabled_ ? &word_to_document_positions_.at(word) : nullptr,
+                &removed_document_ids
+            });
+        }
+
+        std::for_each(policy, postings.begin(), postings.end(),
+            [](const WordPostings& word_postings) {
+                for (const int document_id : *word_postings.removed_document_ids) {
+                    word_postings.document_freqs->erase(document_id);
+                    if (word_postings.document_positions) {
+                        word_postings.document_positions->erase(document_id);
+                    }
+                }
+            });
+
+        for (const auto& [word, _] : word_to_removed_documents) {
+            EraseWordIfUnused(word);
+        }
+    }
 
     template <typename KeyMapper>
     std::vector<Document> FindTopDocuments(std::string_view raw_query, KeyMapper key_mapper) const {
@@ -48,30 +152,89 @@ public:
     template <typename ExecutionPolicy>
     std::vector<Document> FindTopDocuments(ExecutionPolicy&& policy, std::string_view raw_query,
         const DocumentStatus search_status = DocumentStatus::ACTUAL) const {
-        return FindTopDocuments(policy, raw_query,
-            [search_status](int document_id, DocumentStatus status, int rating) {
-                return status == search_status;
-            });
+        return FindTopDocuments(policy, raw_query, DocumentFilter{ search_status });
     }
 
-    template <typename ExecutionPolicy, typename KeyMapper>
+    template <typename ExecutionPolicy>
+    std::vector<Document> FindTopDocuments(ExecutionPolicy&& policy, std::string_view raw_query,
+        const SearchOptions& options) const {
+        return FindTopDocuments(policy, raw_query, DocumentStatus::ACTUAL, TfIdfScorer{},
+            0, MAX_RESULT_DOCUMENT_COUNT, options);
+    }
+
+    template <typename ExecutionPolicy, typename KeyMapper,
+        typename = std::enable_if_t<std::is_execution_policy_v<std::decay_t<ExecutionPolicy>>>>
     std::vector<Document> FindTopDocuments(ExecutionPolicy&& policy, std::string_view raw_query, 
         KeyMapper key_mapper) const {
-        const Query query = ParseQuery(policy, raw_query);
-        std::vector <Document> matched_documents = FindAllDocuments(policy, query, key_mapper);
-        std::sort(policy, matched_documents.begin(), matched_documents.end(),
-            [](const Document& lhs, const Document& rhs) {
-                if (std::abs(lhs.relevance - rhs.relevance) < 1e-6) {
-                    return lhs.rating > rhs.rating;
-                }
-                else {
-                    return lhs.relevance > rhs.relevance;
-                }
-            });
-        if (matched_documents.size() > MAX_RESULT_DOCUMENT_COUNT) {
-            matched_documents.resize(MAX_RESULT_DOCUMENT_COUNT);
+        return FindTopDocuments(policy, raw_query, key_mapper, 0, MAX_RESULT_DOCUMENT_COUNT);
+    }
+
+    // Постраничная выдача: упорядочиваются только первые (page + 1) * page_size документов
+    template <typename ExecutionPolicy>
+    std::vector<Document> FindTopDocuments(ExecutionPolicy&& policy, std::string_view raw_query,
+        const DocumentStatus search_status, size_t page, size_t page_size) const {
+        return FindTopDocuments(policy, raw_query, DocumentFilter{ search_status }, page, page_size);
+    }
+
+    // key_mapper - произвольный предикат, DocumentFilter или одна из политик document_filters.h
+    template <typename ExecutionPolicy, typename KeyMapper>
+    std::vector<Document> FindTopDocuments(ExecutionPolicy&& policy, std::string_view raw_query,
+        KeyMapper key_mapper, size_t page, size_t page_size) const {
+        return FindTopDocuments(policy, raw_query, key_mapper, TfIdfScorer{}, page, page_size);
+    }
+
+    // scorer - ранжирующая функция из scorers.h, по умолчанию TfIdfScorer
+    template <typename ExecutionPolicy, typename KeyMapper, typename Scorer>
+    std::vector<Document> FindTopDocuments(ExecutionPolicy&& policy, std::string_view raw_query,
+        KeyMapper key_mapper, const Scorer& scorer) const {
+        return FindTopDocuments(policy, raw_query, key_mapper, scorer, 0, MAX_RESULT_DOCUMENT_COUNT);
+    }
+
+    template <typename ExecutionPolicy, typename KeyMapper, typename Scorer>
+    std::vector<Document> FindTopDocuments(ExecutionPolicy&& policy, std::string_view raw_query,
+        KeyMapper key_mapper, const Scorer& scorer, size_t page, size_t page_size) const {
+        return FindTopDocuments(policy, raw_query, key_mapper, scorer, page, page_size, SearchOptions{});
+    }
+
+    // options - параметры запроса, например нечёткий поиск
+    template <typename ExecutionPolicy, typename KeyMapper, typename Scorer>
+    std::vector<Document> FindTopDocuments(ExecutionPolicy&& policy, std::string_view raw_query,
+        KeyMapper key_mapper, const Scorer& scorer, size_t page, size_t page_size,
+        const SearchOptions& options) const {
+        if constexpr (std::is_same_v<KeyMapper, DocumentStatus>) {
+            return FindTopDocuments(policy, raw_query, DocumentFilter{ key_mapper }, scorer, page, page_size, options);
+        }
+        else if constexpr (std::is_same_v<KeyMapper, DocumentFilter>) {
+            // Без ограничения рейтинга используется хранимая битовая карта статуса, иначе
+            // фильтр вычисляется один раз на запрос. Затем он проверяется для каждого вхождения слова
+            const bool is_any_rating = key_mapper.min_rating == std::numeric_limits<int>::min()
+                && key_mapper.max_rating == std::numeric_limits<int>::max();
+            if (is_any_rating && !key_mapper.status) {
+                return FindTopDocumentsIf(policy, raw_query, NoFilter{}, scorer, page, page_size, options);
+            }
+            if (is_any_rating) {
+                return FindTopDocumentsIf(policy, raw_query, BitmapFilter{ GetStatusDocuments(*key_mapper.status) },
+                    scorer, page, page_size, options);
+            }
+            // Карта диапазона рейтингов строится за время, пропорциональное числу документов,
+            // поэтому при немногих вхождениях запроса рейтинг проверяется по данным документа
+            const Query query = ParseQuery(policy, raw_query, options.max_edit_distance);
+            const QueryPlan plan = PlanQuery(query, IS_PARALLEL_POLICY<ExecutionPolicy>, options.strategy);
+            size_t posting_count = 0;
+            for (const PlannedTerm& term : plan.plus_terms) {
+                posting_count += term.document_freq;
+            }
+            if (posting_count * FILTER_BITMAP_DOCUMENTS_PER_POSTING < documents_.size()) {
+                return FindTopDocumentsIf(policy, query, plan, DocumentFilterPredicate{ key_mapper }, scorer,
+                    page, page_size);
+            }
+            const Bitmap filtered_documents = BuildFilterBitmap(key_mapper);
+            return FindTopDocumentsIf(policy, query, plan, BitmapFilter{ filtered_documents }, scorer,
+                page, page_size);
+        }
+        else {
+            return FindTopDocumentsIf(policy, raw_query, key_mapper, scorer, page, page_size, options);
         }
-        return matched_documents;
     }
 
     template <typename ExecutionPolicy>
@@ -90,17 +253,18 @@ public:
             return it != word_to_document_freqs_.end() && it->second.count(document_id);
         };
 
-        if (std::any_of(policy, query.minus_words.begin(), query.minus_words.end(), word_checker)) {
-            return { {}, documents_.at(document_id).status };
+        if (std::any_of(policy, query.minus_words.begin(), query.minus_words.end(), word_checker)
+            || !MatchesPhrases(document_id, query)) {
+            return { std::vector<std::string_view>{}, documents_.at(document_id).status };
         }
 
         std::vector<std::string_view> matched_words;
         matched_words.reserve(query.plus_words.size());
 
         for_each(policy, query.plus_words.begin(), query.plus_words.end(),
-            [&word_checker, &matched_words](std::string_view word) {
-                if (word_checker(word)) {
-                    matched_words.push_back(word);
+            [&word_checker, &matched_words](const auto& plus_word) {
+                if (word_checker(plus_word.first)) {
+                    matched_words.push_back(plus_word.first);
                 }
             });
         
@@ -109,41 +273,103 @@ public:
 
 private:
     struct DocumentData {
-        int rating = 0;
+        RatingStats ratings;
         DocumentStatus status = DocumentStatus::ACTUAL;
+        int length = 0;
+    };
+
+    // Вхождение слова в документ. Длина документа хранится рядом с частотой, поэтому
+    // ранжирующей функции не нужно искать её в данных документа для каждого вхождения
+    struct Posting {
+        double term_freq = 0.0;
+        int document_length = 0;
     };
 
     struct QueryWord {
         std::string_view data;
         bool is_minus = false;
         bool is_stop = false;
+        bool is_wildcard = false;
     };
 
+    // Слова в кавычках: "a b c" должны идти подряд, "a b c"~N - стоять не дальше N лишних позиций
+    struct Phrase {
+        std::vector<std::string_view> words;
+        int slop = 0;
+    };
+
+    // Вес плюс-слова: 1 для слов запроса, FUZZY_MATCH_DISCOUNT^d для слов на расстоянии d от них
     struct Query {
-        std::set<std::string_view> plus_words;
+        std::map<std::string_view, double> plus_words;
         std::set<std::string_view> minus_words;
+        std::vector<Phrase> phrases;
     };
 
 private:
-    static int ComputeAverageRating(const std::vector<int>& ratings);
+    static const size_t SCORE_BLOCK_SIZE = 16;
+    // Карта фильтра окупается, если запрос просматривает хотя бы одно вхождение на столько документов
+    static const size_t FILTER_BITMAP_DOCUMENTS_PER_POSTING = 8;
+
+private:
+    static bool CompareDocuments(const Document& lhs, const Document& rhs);
     static bool IsValidWord(std::string_view word);
     bool IsStopWord(std::string_view word) const;
-    double ComputeWordInverseDocumentFreq(std::string_view word) const;
+    CorpusStatistics GetCorpusStatistics() const;
     std::vector<std::string_view> SplitIntoWordsNoStop(std::string_view text) const;
     QueryWord ParseQueryWord(std::string_view text) const;
     Query ParseQuery(std::string_view text) const;
+    size_t ParsePhrase(const std::vector<std::string_view>& words, size_t first, Query& query) const;
+    bool MatchesPhrase(int document_id, const Phrase& phrase) const;
+    bool MatchesPhrases(int document_id, const Query& query) const;
+    void ErasePhraseMismatches(std::map<int, double>& document_to_relevance, const Query& query) const;
+    std::vector<std::string_view> ExpandWildcard(std::string_view pattern, bool is_minus) const;
+    const Bitmap& GetStatusDocuments(DocumentStatus status) const;
+    Bitmap BuildFilterBitmap(const DocumentFilter& filter) const;
+    void RemoveFromFilterIndex(int document_id);
+    std::map<std::string_view, std::vector<int>> UnlinkDocuments(const std::vector<int>& document_ids);
+    void EraseWordIfUnused(std::string_view word);
+    void AddPlusWord(Query& query, std::string_view word, int max_edit_distance) const;
+    QueryPlan PlanQuery(const Query& query, bool is_parallel_allowed,
+        std::optional<QueryStrategy> strategy = std::nullopt) const;
+
+    template <typename ExecutionPolicy>
+    static constexpr bool IS_PARALLEL_POLICY =
+        std::is_same_v<std::decay_t<ExecutionPolicy>, std::execution::parallel_policy>;
+
+    template <typename Filter>
+    static bool IsAccepted(const Filter& filter, int document_id, const DocumentData& document_data) {
+        if constexpr (NeedsRatingStats<Filter>::value) {
+            return filter(document_id, document_data.status, document_data.ratings);
+        }
+        else if constexpr (NeedsDocumentData<Filter>::value) {
+            return filter(document_id, document_data.status, document_data.ratings.mean);
+        }
+        else {
+            return filter(document_id);
+        }
+    }
 
     template <typename ExecutionPolicy>
-    Query ParseQuery(ExecutionPolicy&& policy, std::string_view text) const {
+    Query ParseQuery(ExecutionPolicy&& policy, std::string_view text, int max_edit_distance = 0) const {
         Query query;
-        for (std::string_view word : SplitIntoWords(text)) {
-            const QueryWord query_word = ParseQueryWord(policy, word);
+        const std::vector<std::string_view> words = SplitIntoWords(text);
+        for (size_t i = 0; i < words.size(); ++i) {
+            if (!words[i].empty() && words[i][0] == '"') {
+                i = ParsePhrase(words, i, query);
+                continue;
+            }
+            const QueryWord query_word = ParseQueryWord(policy, words[i]);
             if (!query_word.is_stop) {
-                if (query_word.is_minus) {
-                    query.minus_words.insert(query_word.data);
-                }
-                else {
-                    query.plus_words.insert(query_word.data);
+                const std::vector<std::string_view> expanded_words = query_word.is_wildcard
+                    ? ExpandWildcard(query_word.data, query_word.is_minus)
+                    : std::vector<std::string_view>{ query_word.data };
+                for (std::string_view word : expanded_words) {
+                    if (query_word.is_minus) {
+                        query.minus_words.insert(word);
+                    }
+                    else {
+                        AddPlusWord(query, word, query_word.is_wildcard ? 0 : max_edit_distance);
+                    }
                 }
             }
         }
@@ -177,15 +403,23 @@ private:
             is_minus = true;
             text = text.substr(1);
         }
-        if (text.empty() || text[0] == '-' || !IsValidWord(policy, text)) {
+        // Кавычки допустимы только вокруг фразы, их снимает ParsePhrase
+        if (text.empty() || text[0] == '-' || text.find('"') != text.npos || !IsValidWord(policy, text)) {
             using namespace std::string_literals;
             throw std::invalid_argument("Error in query"s);
         }
 
+        const bool is_wildcard = text.find_first_of("*?") != text.npos;
+        if (is_wildcard && (text[0] == '*' || text[0] == '?')) {
+            using namespace std::string_literals;
+            throw std::invalid_argument("Wildcard must follow a prefix"s);
+        }
+
         return {
             text,
             is_minus,
-            IsStopWord(text)
+            !is_wildcard && IsStopWord(text),
+            is_wildcard
         };
     }
 
@@ -197,30 +431,325 @@ private:
             });
     }
 
-    template <typename KeyMapper>
-    std::vector<Document> FindAllDocuments(const std::execution::sequenced_policy&, Query query, 
-        KeyMapper key_mapper) const {
-        std::map<int, double> document_to_relevance;
-        for (std::string_view word : query.plus_words) {
-            if (word_to_document_freqs_.count(word) == 0) {
+
+    // Вклады вхождений слова считаются блоками по SCORE_BLOCK_SIZE: сначала собираются
+    // частоты и длины документов, затем Score вычисляется для всего блока одним циклом
+    template <typename Filter, typename Scorer, typename Accumulator>
+    void ScoreWordPostings(std::string_view word, double weight, const Filter& filter, const Scorer& scorer,
+        const CorpusStatistics& corpus, Accumulator accumulate) const {
+        using Lane = typename Scorer::Lane;
+        const auto word_it = word_to_document_freqs_.find(word);
+        if (word_it == word_to_document_freqs_.end() || word_it->second.empty()) {
+            return;
+        }
+        const Lane word_weight = static_cast<Lane>(scorer.ComputeWordWeight(word_it->second.size(), corpus) * weight);
+
+        std::array<int, SCORE_BLOCK_SIZE> document_ids{};
+        std::array<Lane, SCORE_BLOCK_SIZE> term_freqs{};
+        std::array<Lane, SCORE_BLOCK_SIZE> document_lengths{};
+        std::array<Lane, SCORE_BLOCK_SIZE> scores{};
+        size_t block_size = 0;
+
+        const auto flush_block = [&]() {
+            for (size_t i = 0; i < SCORE_BLOCK_SIZE; ++i) {
+                scores[i] = scorer.Score(term_freqs[i], document_lengths[i], word_weight, corpus);
+            }
+            for (size_t i = 0; i < block_size; ++i) {
+                accumulate(document_ids[i], scores[i]);
+            }
+            block_size = 0;
+        };
+
+        for (const auto& [document_id, posting] : word_it->second) {
+            if constexpr (NeedsDocumentData<Filter>::value) {
+                if (!IsAccepted(filter, document_id, documents_.at(document_id))) {
+                    continue;
+                }
+            }
+            else {
+                if (!filter(document_id)) {
+                    continue;
+                }
+            }
+            if constexpr (Scorer::NEEDS_DOCUMENT_LENGTH) {
+                document_lengths[block_size] = static_cast<Lane>(posting.document_length);
+            }
+            document_ids[block_size] = document_id;
+            term_freqs[block_size] = static_cast<Lane>(posting.term_freq);
+            if (++block_size == SCORE_BLOCK_SIZE) {
+                flush_block();
+            }
+        }
+        flush_block();
+    }
+
+    template <typename ExecutionPolicy, typename Filter, typename Scorer>
+    std::vector<Document> FindTopDocumentsIf(ExecutionPolicy&& policy, std::string_view raw_query,
+        const Filter& filter, const Scorer& scorer, size_t page, size_t page_size,
+        const SearchOptions& options) const {
+        const Query query = ParseQuery(policy, raw_query, options.max_edit_distance);
+        return FindTopDocumentsIf(policy, query, PlanQuery(query, IS_PARALLEL_POLICY<ExecutionPolicy>, options.strategy), filter,
+            scorer, page, page_size);
+    }
+
+    template <typename ExecutionPolicy, typename Filter, typename Scorer>
+    std::vector<Document> FindTopDocumentsIf(ExecutionPolicy&& policy, const Query& query, const QueryPlan& plan,
+        const Filter& filter, const Scorer& scorer, size_t page, size_t page_size) const {
+        // Для страницы достаточно первых (page + 1) * page_size документов, при переполнении нужны все
+        const size_t top_count = page_size == 0 || page >= std::numeric_limits<size_t>::max() / page_size
+            ? std::numeric_limits<size_t>::max() : (page + 1) * page_size;
+        std::vector<Document> matched_documents = FindAllDocuments(plan, query, filter, scorer, top_count);
+
+        const size_t documents_count = matched_documents.size();
+        const size_t page_count = page_size == 0
+            ? 0 : documents_count / page_size + (documents_count % page_size != 0);
+        if (page >= page_count) {
+            return {};
+        }
+        const size_t page_begin = page * page_size;
+        const size_t page_end = page_begin + std::min(page_size, documents_count - page_begin);
+
+        std::partial_sort(policy, matched_documents.begin(), matched_documents.begin() + page_end,
+            matched_documents.end(), CompareDocuments);
+        matched_documents.resize(page_end);
+        matched_documents.erase(matched_documents.begin(), matched_documents.begin() + page_begin);
+        return matched_documents;
+    }
+
+    // Результат содержит все документы, которые могут войти в первые top_count по CompareDocuments,
+    // но не обязательно все найденные
+    template <typename Filter, typename Scorer>
+    std::vector<Document> FindAllDocuments(const QueryPlan& plan, const Query& query,
+        const Filter& filter, const Scorer& scorer, size_t top_count) const {
+        switch (plan.strategy) {
+        case QueryStrategy::INTERSECTION:
+            return FindDocumentsByIntersection(plan, query, filter, scorer);
+        case QueryStrategy::DOCUMENT_AT_A_TIME:
+            return FindDocumentsAtATime(plan, query, filter, scorer, top_count);
+        case QueryStrategy::ACCUMULATOR:
+            break;
+        }
+        if (plan.is_parallel) {
+            return FindAllDocuments(std::execution::par, plan, query, filter, scorer);
+        }
+        return FindAllDocuments(std::execution::seq, plan, query, filter, scorer);
+    }
+
+    // Курсоры плюс-слов сливаются по возрастанию id; минус-слова проверяются
+    // до вычисления релевантности, их курсоры тоже только движутся вперёд.
+    // Отсечение MaxScore: когда найдено top_count документов, порог - наименьшая релевантность среди них.
+    // Слова с наименьшими верхними оценками Scorer::MaxScore, сумма которых ниже порога, не порождают
+    // кандидатов, а документ ищется в их списках, только пока он ещё может превысить порог
+    template <typename Filter, typename Scorer>
+    std::vector<Document> FindDocumentsAtATime(const QueryPlan& plan, const Query& query,
+        const Filter& filter, const Scorer& scorer, size_t top_count) const {
+        using Lane = typename Scorer::Lane;
+        using PostingIterator = std::map<int, Posting>::const_iterator;
+        struct Cursor {
+            const std::map<int, Posting>* postings;
+            PostingIterator it;
+            Lane word_weight;
+            double max_score;
+        };
+
+        const CorpusStatistics corpus = GetCorpusStatistics();
+        std::vector<Cursor> cursors;
+        for (const PlannedTerm& term : plan.plus_terms) {
+            if (term.document_freq > 0) {
+                const std::map<int, Posting>& postings = word_to_document_freqs_.at(term.word);
+                const Lane word_weight =
+                    static_cast<Lane>(scorer.ComputeWordWeight(term.document_freq, corpus) * term.weight);
+                cursors.push_back({ &postings, postings.begin(), word_weight,
+                    scorer.MaxScore(static_cast<Lane>(term.max_term_freq), word_weight) });
+            }
+        }
+        // max_score_sums[i] - верхняя оценка релевантности документа, найденного только в первых i списках
+        std::stable_sort(cursors.begin(), cursors.end(), [](const Cursor& lhs, const Cursor& rhs) {
+            return lhs.max_score < rhs.max_score;
+        });
+        std::vector<double> max_score_sums(cursors.size() + 1, 0.0);
+        for (size_t i = 0; i < cursors.size(); ++i) {
+            max_score_sums[i + 1] = max_score_sums[i] + cursors[i].max_score;
+        }
+        std::vector<std::pair<PostingIterator, PostingIterator>> minus_cursors;
+        for (const PlannedTerm& term : plan.minus_terms) {
+            if (term.document_freq > 0) {
+                const std::map<int, Posting>& postings = word_to_document_freqs_.at(term.word);
+                minus_cursors.push_back({ postings.begin(), postings.end() });
+            }
+        }
+
+        // Релевантности лучших top_count документов, на вершине - наименьшая.
+        // Документ ниже порога уступает всем им с учётом допуска сравнения релевантностей
+        std::priority_queue<double, std::vector<double>, std::greater<double>> top_relevances;
+        double threshold = std::numeric_limits<double>::lowest();
+        size_t essential_begin = 0;
+
+        std::vector<Document> matched_documents;
+        while (essential_begin < cursors.size()) {
+            const auto next_it = std::min_element(cursors.begin() + essential_begin, cursors.end(),
+                [](const Cursor& lhs, const Cursor& rhs) {
+                    const auto lhs_end = lhs.postings->end();
+                    const auto rhs_end = rhs.postings->end();
+                    return lhs.it != lhs_end && (rhs.it == rhs_end || lhs.it->first < rhs.it->first);
+                });
+            if (next_it->it == next_it->postings->end()) {
+                break;
+            }
+            const int document_id = next_it->it->first;
+
+            bool is_excluded = false;
+            for (auto& [it, end] : minus_cursors) {
+                while (it != end && it->first < document_id) {
+                    ++it;
+                }
+                is_excluded = is_excluded || (it != end && it->first == document_id);
+            }
+            // Фильтр без данных документа проверяется до оценки, остальные - после отсечения
+            if constexpr (!NeedsDocumentData<Filter>::value) {
+                is_excluded = is_excluded || !filter(document_id);
+            }
+            const Lane document_length = static_cast<Lane>(next_it->it->second.document_length);
+
+            double relevance = 0.0;
+            for (auto cursor_it = cursors.begin() + essential_begin; cursor_it != cursors.end(); ++cursor_it) {
+                if (cursor_it->it == cursor_it->postings->end() || cursor_it->it->first != document_id) {
+                    continue;
+                }
+                if (!is_excluded) {
+                    relevance += scorer.Score(static_cast<Lane>(cursor_it->it->second.term_freq),
+                        document_length, cursor_it->word_weight, corpus);
+                }
+                ++cursor_it->it;
+            }
+            if (is_excluded) {
+                continue;
+            }
+
+            bool is_pruned = false;
+            for (size_t i = essential_begin; i > 0; --i) {
+                if (relevance + max_score_sums[i] < threshold) {
+                    is_pruned = true;
+                    break;
+                }
+                const Cursor& cursor = cursors[i - 1];
+                const auto posting_it = cursor.postings->find(document_id);
+                if (posting_it != cursor.postings->end()) {
+                    relevance += scorer.Score(static_cast<Lane>(posting_it->second.term_freq),
+                        document_length, cursor.word_weight, corpus);
+                }
+            }
+            if (is_pruned || relevance < threshold) {
+                continue;
+            }
+            const DocumentData& document_data = documents_.at(document_id);
+            if (!IsAccepted(filter, document_id, document_data) || !MatchesPhrases(document_id, query)) {
                 continue;
             }
-            const double inverse_document_freq = ComputeWordInverseDocumentFreq(word);
-            for (const auto [document_id, term_freq] : word_to_document_freqs_.at(word)) {
-                if (key_mapper(document_id, documents_.at(document_id).status, documents_.at(document_id).rating)) {
-                    document_to_relevance[document_id] += term_freq * inverse_document_freq;
+            matched_documents.push_back({ document_id, relevance, document_data.ratings.mean });
+
+            if (top_count >= documents_.size()) {
+                continue;
+            }
+            top_relevances.push(relevance);
+            if (top_relevances.size() > top_count) {
+                top_relevances.pop();
+            }
+            if (top_relevances.size() == top_count) {
+                threshold = top_relevances.top() - RELEVANCE_EPSILON;
+                while (essential_begin < cursors.size() && max_score_sums[essential_begin + 1] < threshold) {
+                    ++essential_begin;
+                }
+            }
+        }
+        return matched_documents;
+    }
+
+    // Документ, подходящий под все фразы, содержит все их слова, поэтому
+    // кандидатами служат вхождения самого редкого слова фраз
+    template <typename Filter, typename Scorer>
+    std::vector<Document> FindDocumentsByIntersection(const QueryPlan& plan, const Query& query,
+        const Filter& filter, const Scorer& scorer) const {
+        using Lane = typename Scorer::Lane;
+        const std::map<int, Posting>* candidates = nullptr;
+        for (const Phrase& phrase : query.phrases) {
+            for (std::string_view word : phrase.words) {
+                const auto word_it = word_to_document_freqs_.find(word);
+                if (word_it == word_to_document_freqs_.end()) {
+                    return {};
+                }
+                if (candidates == nullptr || word_it->second.size() < candidates->size()) {
+                    candidates = &word_it->second;
                 }
             }
         }
+        if (candidates == nullptr) {
+            return {};
+        }
 
-        for (std::string_view word : query.minus_words) {
-            if (word_to_document_freqs_.count(word) == 0) {
+        const CorpusStatistics corpus = GetCorpusStatistics();
+        std::vector<std::pair<const std::map<int, Posting>*, Lane>> plus_postings;
+        for (const PlannedTerm& term : plan.plus_terms) {
+            if (term.document_freq > 0) {
+                plus_postings.push_back({ &word_to_document_freqs_.at(term.word),
+                    static_cast<Lane>(scorer.ComputeWordWeight(term.document_freq, corpus) * term.weight) });
+            }
+        }
+        std::vector<const std::map<int, Posting>*> minus_postings;
+        for (const PlannedTerm& term : plan.minus_terms) {
+            if (term.document_freq > 0) {
+                minus_postings.push_back(&word_to_document_freqs_.at(term.word));
+            }
+        }
+
+        std::vector<Document> matched_documents;
+        for (const auto [document_id, _] : *candidates) {
+            const bool is_excluded = std::any_of(minus_postings.begin(), minus_postings.end(),
+                [document_id](const std::map<int, Posting>* postings) {
+                    return postings->count(document_id) > 0;
+                });
+            if (is_excluded) {
+                continue;
+            }
+            const DocumentData& document_data = documents_.at(document_id);
+            if (!IsAccepted(filter, document_id, document_data) || !MatchesPhrases(document_id, query)) {
                 continue;
             }
-            for (const auto [document_id, _] : word_to_document_freqs_.at(word)) {
+
+            double relevance = 0.0;
+            for (const auto& [postings, word_weight] : plus_postings) {
+                const auto posting_it = postings->find(document_id);
+                if (posting_it != postings->end()) {
+                    relevance += scorer.Score(static_cast<Lane>(posting_it->second.term_freq),
+                        static_cast<Lane>(posting_it->second.document_length), word_weight, corpus);
+                }
+            }
+            matched_documents.push_back({ document_id, relevance, document_data.ratings.mean });
+        }
+        return matched_documents;
+    }
+
+    template <typename Filter, typename Scorer>
+    std::vector<Document> FindAllDocuments(const std::execution::sequenced_policy&, const QueryPlan& plan,
+        const Query& query, const Filter& filter, const Scorer& scorer) const {
+        const CorpusStatistics corpus = GetCorpusStatistics();
+        std::map<int, double> document_to_relevance;
+        for (const PlannedTerm& term : plan.plus_terms) {
+            ScoreWordPostings(term.word, term.weight, filter, scorer, corpus,
+                [&document_to_relevance](int document_id, double score) {
+                    document_to_relevance[document_id] += score;
+                });
+        }
+
+        for (const PlannedTerm& term : plan.minus_terms) {
+            if (term.document_freq == 0) {
+                continue;
+            }
+            for (const auto [document_id, _] : word_to_document_freqs_.at(term.word)) {
                 document_to_relevance.erase(document_id);
             }
         }
+        ErasePhraseMismatches(document_to_relevance, query);
 
         std::vector<Document> matched_documents;
         matched_documents.reserve(document_to_relevance.size());
@@ -228,58 +757,52 @@ private:
             matched_documents.push_back({
                 document_id,
                 relevance,
-                documents_.at(document_id).rating
+                documents_.at(document_id).ratings.mean
                 });
         }
         return matched_documents;
     }
 
-    template <typename KeyMapper>
-    std::vector<Document> FindAllDocuments(const std::execution::parallel_policy&, Query query, 
-        KeyMapper key_mapper) const {
+    template <typename Filter, typename Scorer>
+    std::vector<Document> FindAllDocuments(const std::execution::parallel_policy&, const QueryPlan& plan,
+        const Query& query, const Filter& filter, const Scorer& scorer) const {
+        const CorpusStatistics corpus = GetCorpusStatistics();
         size_t bucket_count = 77;
         ConcurrentMap<int, double> document_to_relevance_mt(bucket_count);
 
         for_each(std::execution::par,
-            query.plus_words.begin(), query.plus_words.end(),
-            [this, key_mapper, &document_to_relevance_mt](std::string_view word) {
-                const double inverse_document_freq = ComputeWordInverseDocumentFreq(word);
-                for (const auto [document_id, term_freq] : word_to_document_freqs_.at(word)) {
-                    if (word_to_document_freqs_.count(word) &&
-                        key_mapper(
-                            document_id, 
-                            documents_.at(document_id).status, 
-                            documents_.at(document_id).rating)) {
-                        document_to_relevance_mt[document_id].ref_to_value += term_freq * inverse_document_freq;
-                    }
-                }
+            plan.plus_terms.begin(), plan.plus_terms.end(),
+            [this, &filter, &scorer, &corpus, &document_to_relevance_mt](const PlannedTerm& term) {
+                ScoreWordPostings(term.word, term.weight, filter, scorer, corpus,
+                    [&document_to_relevance_mt](int document_id, double score) {
+                        document_to_relevance_mt[document_id].ref_to_value += score;
+                    });
             });
 
         std::map<int, double> document_to_relevance(document_to_relevance_mt.BuildOrdinaryMap());
         std::mutex map_mutex;
         
         for_each(std::execution::par,
-            query.minus_words.begin(), query.minus_words.end(),
-            [this,&document_to_relevance, &map_mutex](std::string_view word) {
-                if (word_to_document_freqs_.count(word)) {
+            plan.minus_terms.begin(), plan.minus_terms.end(),
+            [this,&document_to_relevance, &map_mutex](const PlannedTerm& term) {
+                if (term.document_freq > 0) {
                     std::lock_guard<std::mutex> guard(map_mutex);
-                    for (const auto [document_id, _] : word_to_document_freqs_.at(word)) {
+                    for (const auto [document_id, _] : word_to_document_freqs_.at(term.word)) {
                         document_to_relevance.erase(document_id);
                     }
                 }
             });
-
-        std::vector<Document> matched_documents;
-        matched_documents.reserve(document_to_relevance.size());
-
-        for_each(std::execution::par,
-            document_to_relevance.begin(), document_to_relevance.end(),
-            [this, &matched_documents](const auto& document) {
-                matched_documents.push_back({
-                document.first,
-                document.second,
-                documents_.at(document.first).rating
-                    });
+        ErasePhraseMismatches(document_to_relevance, query);
+
+        std::vector<Document> matched_documents(document_to_relevance.size());
+        std::transform(std::execution::par,
+            document_to_relevance.begin(), document_to_relevance.end(), matched_documents.begin(),
+            [this](const auto& document) {
+                return Document{
+                    document.first,
+                    document.second,
+                    documents_.at(document.first).ratings.mean
+                };
             });
 
         return matched_documents;
@@ -287,15 +810,24 @@ private:
 
 private:
     std::set<std::string, std::less<>> stop_words_;
-    std::set<std::string, std::less<>> words_;
-    std::map<std::string_view, std::map<int, double>> word_to_document_freqs_;
+    StringArena words_;
+    std::map<std::string_view, std::map<int, Posting>> word_to_document_freqs_;
+    // Наибольшая доля слова в документе; при удалении документов не уменьшается и остаётся верхней оценкой
+    std::map<std::string_view, double> word_to_max_term_freq_;
     std::map<int, DocumentData> documents_;
+    size_t total_document_length_ = 0;
     std::set<int> document_ids_;
-    std::map<int, std::map<std::string_view, double>> document_to_word_freqs_;
+    ForwardIndex forward_index_;
+    DocumentStore document_store_;
+    bool is_positional_index_enabled_ = false;
+    std::map<std::string_view, std::map<int, PositionList>> word_to_document_positions_;
+    std::optional<DeletionIndex> deletion_index_;
+    std::map<DocumentStatus, Bitmap> status_to_documents_;
+    RatingIndex rating_index_;
 };
 
 void AddDocument(SearchServer& search_server, int document_id, const std::string& document, DocumentStatus status,
-    const std::vector<int>& ratings);
+    RatingsView ratings);
 
 void FindTopDocuments(const SearchServer& search_server, const std::string& raw_query);
 
@@ -0,0 +1,41 @@
+#include "string_arena.h"
+
+#include <cstring>
+
+StringArena::StringArena(size_t block_size)
+    : block_size_(block_size) {
+}
+
+std::string_view StringArena::Store(std::string_view str) {
+    if (str.empty()) {
+        return {};
+    }
+    char* data = Allocate(str.size());
+    std::memcpy(data, str.data(), str.size());
+    return { data, str.size() };
+}
+
+size_t StringArena::GetMemoryUsage() const {
+    return allocated_ + blocks_.capacity() * sizeof(std::unique_ptr<char[]>);
+}
+
+char* StringArena::Allocate(size_t size) {
+    if (size > block_size_ / 4) {
+        // Длинные строки получают собственный блок, чтобы не бросать недозаполненный текущий
+        blocks_.push_back(std::make_unique<char[]>(size));
+        allocated_ += size;
+        return blocks_.back().get();
+    }
+
+    if (size > left_) {
+        blocks_.push_back(std::make_unique<char[]>(block_size_));
+        allocated_ += block_size_;
+        current_ = blocks_.back().get();
+        left_ = block_size_;
+    }
+
+    char* data = current_;
+    current_ += size;
+    left_ -= size;
+    return data;
+}
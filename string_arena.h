@@ -0,0 +1,25 @@
+#pragma once
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// Хранит строки подряд в больших блоках памяти.
+// Возвращаемые string_view остаются валидными всё время жизни арены
+class StringArena {
+public:
+    explicit StringArena(size_t block_size = 64 * 1024);
+
+public:
+    std::string_view Store(std::string_view str);
+    size_t GetMemoryUsage() const;
+
+private:
+    char* Allocate(size_t size);
+
+private:
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    size_t block_size_;
+    size_t allocated_ = 0;
+    char* current_ = nullptr;
+    size_t left_ = 0;
+};
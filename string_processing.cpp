@@ -12,4 +12,35 @@ std::vector<std::string_view> SplitIntoWords(std::string_view text) {
     }
     result.push_back(text.substr(0, space));
     return result;
-}
\ No newline at end of file
+}
+
+// '*' соответствует любой последовательности символов, '?' - ровно одному символу
+bool MatchWildcard(std::string_view pattern, std::string_view text) {
+    size_t pattern_pos = 0;
+    size_t text_pos = 0;
+    size_t star_pos = pattern.npos;
+    size_t star_text_pos = 0;
+
+    while (text_pos < text.size()) {
+        if (pattern_pos < pattern.size() && (pattern[pattern_pos] == '?' || pattern[pattern_pos] == text[text_pos])) {
+            ++pattern_pos;
+            ++text_pos;
+        }
+        else if (pattern_pos < pattern.size() && pattern[pattern_pos] == '*') {
+            star_pos = pattern_pos++;
+            star_text_pos = text_pos;
+        }
+        else if (star_pos != pattern.npos) {
+            pattern_pos = star_pos + 1;
+            text_pos = ++star_text_pos;
+        }
+        else {
+            return false;
+        }
+    }
+
+    while (pattern_pos < pattern.size() && pattern[pattern_pos] == '*') {
+        ++pattern_pos;
+    }
+    return pattern_pos == pattern.size();
+}
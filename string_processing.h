@@ -4,3 +4,4 @@
 #include <string_view>
 
 std::vector<std::string_view> SplitIntoWords(const std::string_view text);
+bool MatchWildcard(std::string_view pattern, std::string_view text);
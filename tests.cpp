@@ -0,0 +1,671 @@
+#include "tests.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <execution>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "corpus_reader.h"
+#include "paginator.h"
+#include "search_server.h"
+
+using namespace std;
+
+// В отличие от assert, проверка выполняется и в сборке с NDEBUG
+#define CHECK(expr) CheckImpl((expr), #expr, __FILE__, __LINE__)
+
+static void CheckImpl(bool value, const char* expr, const char* file, int line) {
+    if (!value) {
+        cerr << file << "("s << line << "): CHECK("s << expr << ") failed"s << endl;
+        abort();
+    }
+}
+
+static vector<int> FindIds(const SearchServer& search_server, const string& query) {
+    vector<int> ids;
+    for (const Document& document : search_server.FindTopDocuments(query)) {
+        ids.push_back(document.id);
+    }
+    sort(ids.begin(), ids.end());
+    return ids;
+}
+
+static bool IsInvalidQuery(const SearchServer& search_server, const string& query) {
+    try {
+        search_server.FindTopDocuments(query);
+    }
+    catch (const invalid_argument&) {
+        return true;
+    }
+    return false;
+}
+
+static void CheckDocumentTexts() {
+    string repetitive;
+    while (repetitive.size() < 200'000) {
+        repetitive += "cat dog "s;
+    }
+    string varied;
+    for (int i = 0; varied.size() < 100'000; ++i) {
+        varied += "w"s + to_string(i * 7919 % 100'003) + " "s;
+    }
+    const vector<string> texts = { ""s, "cat"s, "white cat and yellow hat"s, repetitive, varied };
+
+    SearchServer search_server("and"s);
+    search_server.SetTextCompression(TextCompression::LZ);
+    vector<Document> documents;
+    size_t text_size = 0;
+    for (int id = 0; id < 100; ++id) {
+        const string& text = texts[id % texts.size()];
+        search_server.AddDocument(id, text, DocumentStatus::ACTUAL, { 1 });
+        documents.push_back({ id, 0.0, 1 });
+        text_size += text.size();
+    }
+    const size_t memory = search_server.GetMemoryReport().document_texts;
+    CHECK(memory < text_size / 2);
+
+    const vector<string> stored_texts = search_server.GetDocumentTexts(documents);
+    for (int id = 0; id < 100; ++id) {
+        CHECK(search_server.GetDocumentText(id) == texts[id % texts.size()]);
+        CHECK(stored_texts[id] == texts[id % texts.size()]);
+    }
+
+    // Удалённые тексты не остаются в памяти: блоки переписываются, когда удалена большая часть текстов
+    vector<int> removed_ids;
+    for (int id = 0; id < 90; ++id) {
+        removed_ids.push_back(id);
+    }
+    search_server.RemoveDocuments(removed_ids);
+    CHECK(search_server.GetMemoryReport().document_texts < memory / 4);
+    bool is_rejected = false;
+    try {
+        search_server.GetDocumentText(5);
+    }
+    catch (const out_of_range&) {
+        is_rejected = true;
+    }
+    CHECK(is_rejected);
+    for (int id = 90; id < 100; ++id) {
+        CHECK(search_server.GetDocumentText(id) == texts[id % texts.size()]);
+    }
+}
+
+static void CheckPhraseQueries() {
+    SearchServer search_server("and"s);
+    search_server.SetPositionalIndex(true);
+    search_server.AddDocument(1, "white cat and yellow hat"s, DocumentStatus::ACTUAL, { 1 });
+    search_server.AddDocument(2, "cat hat"s, DocumentStatus::ACTUAL, { 1 });
+    search_server.AddDocument(3, "hat big cat"s, DocumentStatus::ACTUAL, { 1 });
+    search_server.AddDocument(4, "cat dog cat"s, DocumentStatus::ACTUAL, { 1 });
+
+    CHECK((FindIds(search_server, "\"cat hat\""s) == vector<int>{ 2 }));
+    CHECK((FindIds(search_server, "\"cat and hat\""s) == vector<int>{ 2 }));
+    CHECK((FindIds(search_server, "\"cat hat\"~1"s) == vector<int>{ 1, 2, 3 }));
+    CHECK(FindIds(search_server, "\"white hat\"~1"s).empty());
+    CHECK((FindIds(search_server, "\"white hat\"~2"s) == vector<int>{ 1 }));
+    CHECK((FindIds(search_server, "\"cat hat\"~1 -yellow"s) == vector<int>{ 2, 3 }));
+    CHECK(FindIds(search_server, "\"cat cat\""s).empty());
+    CHECK(FindIds(search_server, "\"cat cat\"~0"s).empty());
+    CHECK((FindIds(search_server, "\"cat cat\"~1"s) == vector<int>{ 4 }));
+    CHECK(IsInvalidQuery(search_server, "\"cat hat"s));
+    CHECK(IsInvalidQuery(search_server, "\"cat hat\"~"s));
+    CHECK(IsInvalidQuery(search_server, "\"cat hat\"~x"s));
+    CHECK(IsInvalidQuery(search_server, "\"cat hat\"~99999999999"s));
+    CHECK(IsInvalidQuery(search_server, "\"cat -hat\""s));
+    CHECK(IsInvalidQuery(search_server, "cat -\"hat\""s));
+    CHECK(IsInvalidQuery(search_server, "cat -\"hat dog\""s));
+    CHECK(IsInvalidQuery(search_server, "cat hat\""s));
+    CHECK(IsInvalidQuery(search_server, "\"cat ha\"t\""s));
+}
+
+static void CheckWildcardQueries() {
+    SearchServer search_server("and"s);
+    search_server.AddDocument(1, "white cat and yellow hat"s, DocumentStatus::ACTUAL, { 1 });
+    search_server.AddDocument(2, "catalog dog"s, DocumentStatus::ACTUAL, { 1 });
+    search_server.AddDocument(3, "car dog"s, DocumentStatus::ACTUAL, { 1 });
+    search_server.AddDocument(4, "cartridge dog"s, DocumentStatus::ACTUAL, { 1 });
+
+    CHECK((FindIds(search_server, "cat*"s) == vector<int>{ 1, 2 }));
+    CHECK((FindIds(search_server, "ca* -car*"s) == vector<int>{ 1, 2 }));
+    CHECK((FindIds(search_server, "c?r"s) == vector<int>{ 3 }));
+    CHECK(FindIds(search_server, "zz*"s).empty());
+    CHECK(IsInvalidQuery(search_server, "\"ca* hat\""s));
+    CHECK(IsInvalidQuery(search_server, "\"white c?t\"~1"s));
+
+    SearchServer many_words(""s);
+    for (int i = 0; i < 100; ++i) {
+        many_words.AddDocument(i, "cat x"s + to_string(i), DocumentStatus::ACTUAL, { 1 });
+    }
+    CHECK(many_words.FindTopDocuments("x*"s, 0, 1000).size() == MAX_WILDCARD_EXPANSION);
+    CHECK(IsInvalidQuery(many_words, "cat -x*"s));
+    CHECK(many_words.FindTopDocuments("cat -x?"s, 0, 1000).size() == 90);
+}
+
+static void CheckFuzzyQueries() {
+    SearchServer search_server("and"s);
+    search_server.AddDocument(1, "white kitten"s, DocumentStatus::ACTUAL, { 1 });
+    search_server.AddDocument(2, "curly dog"s, DocumentStatus::ACTUAL, { 1 });
+    search_server.SetFuzzySearch(2);
+
+    CHECK(FindIds(search_server, "kiten"s).empty());
+    CHECK(get<0>(search_server.MatchDocument("kiten"s, 1)).empty());
+    const vector<Document> fuzzy = search_server.FindTopDocuments("kiten"s, SearchOptions{ 1 });
+    CHECK(fuzzy.size() == 1 && fuzzy[0].id == 1);
+    CHECK(search_server.FindTopDocuments(execution::par, "dgo"s, SearchOptions{ 1 }).size() == 1);
+    CHECK(search_server.FindTopDocuments("kitxxn"s, SearchOptions{ 1 }).empty());
+    CHECK(search_server.FindTopDocuments("kitxxn"s, SearchOptions{ 2 }).size() == 1);
+
+    SearchServer exact_only(""s);
+    exact_only.AddDocument(1, "kitten"s, DocumentStatus::ACTUAL, { 1 });
+    bool is_rejected = false;
+    try {
+        exact_only.FindTopDocuments("kiten"s, SearchOptions{ 1 });
+    }
+    catch (const invalid_argument&) {
+        is_rejected = true;
+    }
+    CHECK(is_rejected);
+}
+
+static void CheckDocumentFilters() {
+    SearchServer search_server(""s);
+    for (int id = 0; id < 20; ++id) {
+        search_server.AddDocument(id, "cat"s, static_cast<DocumentStatus>(id % 4), { id });
+    }
+
+    const auto find_ids = [&search_server](const DocumentFilter& filter) {
+        vector<int> ids;
+        for (const Document& document : search_server.FindTopDocuments(execution::seq, "cat"s, filter, 0, 100)) {
+            ids.push_back(document.id);
+        }
+        sort(ids.begin(), ids.end());
+        return ids;
+    };
+    CHECK(find_ids(DocumentFilter{}).size() == 20);
+    CHECK((find_ids(DocumentFilter{ DocumentStatus::BANNED }) == vector<int>{ 2, 6, 10, 14, 18 }));
+    CHECK((find_ids(DocumentFilter{ DocumentStatus::BANNED, 5, 14 }) == vector<int>{ 6, 10, 14 }));
+    CHECK((find_ids(DocumentFilter{ nullopt, 17, 100 }) == vector<int>{ 17, 18, 19 }));
+    CHECK(find_ids(DocumentFilter{ nullopt, 10, 5 }).empty());
+    CHECK(search_server.FindTopDocuments("cat"s, DocumentStatus::REMOVED).size() == 5);
+
+    search_server.RemoveDocument(6);
+    CHECK((find_ids(DocumentFilter{ DocumentStatus::BANNED, 5, 14 }) == vector<int>{ 10, 14 }));
+
+    SearchServer empty_server(""s);
+    empty_server.AddDocument(1, "cat"s, DocumentStatus::ACTUAL, { 1 });
+    CHECK(empty_server.FindTopDocuments("cat"s, DocumentStatus::BANNED).empty());
+
+    // Диапазоны по срезам рейтингов, включая отрицательные и крайние значения
+    SearchServer spread_server(""s);
+    const vector<int> ratings = { numeric_limits<int>::min(), -50'000, -1, 0, 1, 777, 50'000, numeric_limits<int>::max() };
+    for (int id = 0; id < static_cast<int>(ratings.size()); ++id) {
+        spread_server.AddDocument(id, "cat"s, DocumentStatus::ACTUAL, { ratings[id] });
+    }
+    const auto find_spread_ids = [&spread_server](int min_rating, int max_rating) {
+        vector<int> ids;
+        for (const Document& document : spread_server.FindTopDocuments(execution::seq, "cat"s,
+            DocumentFilter{ nullopt, min_rating, max_rating }, 0, 100)) {
+            ids.push_back(document.id);
+        }
+        sort(ids.begin(), ids.end());
+        return ids;
+    };
+    CHECK((find_spread_ids(0, numeric_limits<int>::max()) == vector<int>{ 3, 4, 5, 6, 7 }));
+    CHECK((find_spread_ids(numeric_limits<int>::min(), -1) == vector<int>{ 0, 1, 2 }));
+    CHECK((find_spread_ids(-50'000, 777) == vector<int>{ 1, 2, 3, 4, 5 }));
+    CHECK((find_spread_ids(2, 776) == vector<int>{}));
+    CHECK((find_spread_ids(777, 777) == vector<int>{ 5 }));
+    CHECK((find_spread_ids(numeric_limits<int>::max(), numeric_limits<int>::max()) == vector<int>{ 7 }));
+    spread_server.RemoveDocument(5);
+    CHECK((find_spread_ids(-1, 50'000) == vector<int>{ 2, 3, 4, 6 }));
+
+    // Для редкого слова диапазон проверяется по данным документов, а не по карте
+    for (int id = 100; id < 200; ++id) {
+        spread_server.AddDocument(id, "dog"s, DocumentStatus::ACTUAL, { 0 });
+    }
+    CHECK((find_spread_ids(-1, 50'000) == vector<int>{ 2, 3, 4, 6 }));
+    CHECK((find_spread_ids(numeric_limits<int>::max(), numeric_limits<int>::max()) == vector<int>{ 7 }));
+}
+
+static void CheckRemoveDocuments() {
+    SearchServer search_server("and"s);
+    search_server.SetPositionalIndex(true);
+    search_server.SetFuzzySearch(1);
+    search_server.AddDocument(1, "white cat and yellow hat"s, DocumentStatus::ACTUAL, { 1 });
+    search_server.AddDocument(2, "catalog dog"s, DocumentStatus::ACTUAL, { 1 });
+    search_server.AddDocument(3, "cart dog"s, DocumentStatus::ACTUAL, { 1 });
+    search_server.AddDocument(4, "cat hat"s, DocumentStatus::ACTUAL, { 1 });
+    search_server.AddDocument(5, "black dog"s, DocumentStatus::ACTUAL, { 1 });
+
+    const auto planned_words = [&search_server](const string& query, const SearchOptions& options) {
+        vector<string_view> words;
+        for (const PlannedTerm& term : search_server.Explain(execution::seq, query, options).plus_terms) {
+            if (term.document_freq > 0) {
+                words.push_back(term.word);
+            }
+        }
+        sort(words.begin(), words.end());
+        return words;
+    };
+
+    // Повторные и неизвестные id пропускаются
+    search_server.RemoveDocuments(execution::par, { 2, 3, 2, 42, -1 });
+    CHECK(search_server.GetDocumentCount() == 3);
+    CHECK((FindIds(search_server, "dog"s) == vector<int>{ 5 }));
+    CHECK(search_server.Explain("dog"s).plus_terms.front().document_freq == 1);
+    CHECK((FindIds(search_server, "\"black dog\""s) == vector<int>{ 5 }));
+    CHECK((FindIds(search_server, "\"cat hat\"~1"s) == vector<int>{ 1, 4 }));
+
+    // Слова без вхождений исчезают из раскрытия шаблонов и нечёткого поиска
+    CHECK((planned_words("ca*"s, {}) == vector<string_view>{ "cat"sv }));
+    CHECK(FindIds(search_server, "catalog"s).empty());
+    CHECK(planned_words("carts"s, SearchOptions{ 1 }).empty());
+    CHECK(search_server.FindTopDocuments("catalo"s, SearchOptions{ 1 }).empty());
+
+    search_server.AddDocument(2, "catalog"s, DocumentStatus::ACTUAL, { 1 });
+    CHECK((planned_words("ca*"s, {}) == vector<string_view>{ "cat"sv, "catalog"sv }));
+    CHECK(search_server.FindTopDocuments("catalo"s, SearchOptions{ 1 }).size() == 1);
+
+    // Слова, вернувшиеся в словарь, не копируются в арену повторно
+    string churn_text;
+    for (int i = 0; i < 1000; ++i) {
+        churn_text += "churn"s + to_string(i) + " "s;
+    }
+    search_server.AddDocument(100, churn_text, DocumentStatus::ACTUAL, { 1 });
+    search_server.RemoveDocument(100);
+    const size_t dictionary_memory = search_server.GetMemoryReport().dictionary;
+    for (int i = 0; i < 100; ++i) {
+        search_server.AddDocument(100, churn_text, DocumentStatus::ACTUAL, { 1 });
+        search_server.RemoveDocument(100);
+    }
+    CHECK(search_server.GetMemoryReport().dictionary == dictionary_memory);
+    search_server.AddDocument(100, churn_text, DocumentStatus::ACTUAL, { 1 });
+    CHECK((FindIds(search_server, "churn7"s) == vector<int>{ 100 }));
+}
+
+static void CheckQueryPlans() {
+    SearchServer search_server(""s);
+    for (int id = 0; id < 200; ++id) {
+        string text = "cat"s;
+        for (int i = 0; i < id % 7; ++i) {
+            text += " dog"s;
+        }
+        if (id % 20 == 3) {
+            text += " rare"s;
+        }
+        search_server.AddDocument(id, text, DocumentStatus::ACTUAL, { id });
+    }
+
+    const string query = "rare cat -mouse"s;
+    const QueryPlan plan = search_server.Explain(query);
+    CHECK(plan.strategy == QueryStrategy::DOCUMENT_AT_A_TIME && !plan.is_parallel);
+    CHECK(plan.plus_terms.front().word == "rare"sv);
+    CHECK(search_server.Explain(execution::seq, query).is_parallel == plan.is_parallel);
+
+    // Первые страницы с отсечением совпадают с частями полной выдачи
+    const vector<Document> all = search_server.FindTopDocuments(execution::seq, query, NoFilter{}, 0, 1000);
+    CHECK(all.size() == 200);
+    for (const size_t page_size : { 1, 3, 5 }) {
+        for (size_t page = 0; page < 5; ++page) {
+            const vector<Document> documents =
+                search_server.FindTopDocuments(execution::seq, query, NoFilter{}, page, page_size);
+            CHECK(documents.size() == page_size);
+            for (size_t i = 0; i < page_size; ++i) {
+                CHECK(documents[i].id == all[page * page_size + i].id);
+            }
+        }
+    }
+}
+
+static void CheckQueryStrategies() {
+    SearchServer search_server(""s);
+    search_server.SetPositionalIndex(true);
+    // Номер слова - минимум из трёх случайных, поэтому первые слова встречаются почти везде, а rare - в единицах документов
+    const vector<string> words = { "cat"s, "dog"s, "black"s, "white"s, "big"s, "hat"s, "tail"s, "rare"s };
+    uint32_t seed = 1;
+    const auto next_random = [&seed]() {
+        seed = seed * 1103515245u + 12345u;
+        return (seed >> 16) & 0x7fff;
+    };
+    for (int id = 0; id < 400; ++id) {
+        string text;
+        const uint32_t word_count = 2 + next_random() % 10;
+        for (uint32_t i = 0; i < word_count; ++i) {
+            const uint32_t index = min({ next_random() % 8, next_random() % 8, next_random() % 8 });
+            text += words[index] + " "s;
+        }
+        search_server.AddDocument(id, text, DocumentStatus::ACTUAL, { id });
+    }
+
+    const auto check_same = [](const vector<Document>& lhs, const vector<Document>& rhs) {
+        CHECK(lhs.size() == rhs.size());
+        for (size_t i = 0; i < lhs.size(); ++i) {
+            CHECK(lhs[i].id == rhs[i].id);
+            CHECK(abs(lhs[i].relevance - rhs[i].relevance) < RELEVANCE_EPSILON);
+        }
+    };
+    // Каждая стратегия, заданная в SearchOptions, даёт ту же выдачу, что и выбранная планировщиком
+    const auto check_strategies = [&](const string& query, const auto& key_mapper, const auto& scorer) {
+        vector<QueryStrategy> strategies = { QueryStrategy::ACCUMULATOR, QueryStrategy::DOCUMENT_AT_A_TIME };
+        if (query.find('"') != string::npos) {
+            strategies.push_back(QueryStrategy::INTERSECTION);
+        }
+        for (const size_t page_size : { 5, 1000 }) {
+            const vector<Document> expected =
+                search_server.FindTopDocuments(execution::seq, query, key_mapper, scorer, 0, page_size);
+            for (const QueryStrategy strategy : strategies) {
+                SearchOptions options;
+                options.strategy = strategy;
+                CHECK(search_server.Explain(execution::seq, query, options).strategy == strategy);
+                check_same(search_server.FindTopDocuments(execution::seq, query, key_mapper, scorer, 0, page_size,
+                    options), expected);
+                check_same(search_server.FindTopDocuments(execution::par, query, key_mapper, scorer, 0, page_size,
+                    options), expected);
+            }
+        }
+    };
+
+    const vector<string> queries = {
+        "cat"s,
+        "rare"s,
+        "cat dog"s,
+        "rare tail -cat"s,
+        "big hat tail rare"s,
+        "cat dog black white big hat tail rare"s,
+        "ta* ra*"s,
+        "\"black cat\""s,
+        "\"black cat\" dog"s,
+        "\"cat dog\" -rare"s,
+        "\"big hat\"~2 tail"s,
+        "\"white dog\" \"cat cat\"~1"s,
+        "ta* \"dog cat\""s,
+    };
+    for (const string& query : queries) {
+        check_strategies(query, DocumentStatus::ACTUAL, TfIdfScorer{});
+        check_strategies(query, DocumentStatus::ACTUAL, Bm25Scorer{});
+        check_strategies(query, DocumentFilter{ nullopt, 100, 300 }, TfIdfScorer{});
+    }
+    CHECK(!search_server.FindTopDocuments("\"black cat\""s).empty());
+    CHECK(!search_server.FindTopDocuments("rare"s).empty());
+
+    SearchOptions intersection;
+    intersection.strategy = QueryStrategy::INTERSECTION;
+    bool is_rejected = false;
+    try {
+        search_server.FindTopDocuments("cat dog"s, intersection);
+    }
+    catch (const invalid_argument&) {
+        is_rejected = true;
+    }
+    CHECK(is_rejected);
+}
+
+static void CheckScorers() {
+    SearchServer search_server("and with"s);
+    search_server.AddDocument(1, "white cat and yellow hat"s, DocumentStatus::ACTUAL, { 1 });
+    search_server.AddDocument(2, "curly cat curly tail"s, DocumentStatus::ACTUAL, { 1 });
+    search_server.AddDocument(3, "nasty dog with big eyes"s, DocumentStatus::ACTUAL, { 1 });
+    search_server.AddDocument(4, "nasty pigeon john"s, DocumentStatus::ACTUAL, { 1 });
+    const string query = "curly nasty cat"s;
+
+    // Документ: { число вхождений curly, nasty, cat; длина документа }
+    const map<int, pair<array<int, 3>, int>> term_counts = {
+        { 1, { { 0, 0, 1 }, 4 } },
+        { 2, { { 2, 0, 1 }, 4 } },
+        { 3, { { 0, 1, 0 }, 4 } },
+        { 4, { { 0, 1, 0 }, 3 } },
+    };
+    const array<int, 3> document_freqs = { 1, 2, 2 };
+    const double document_count = 4.0;
+    const double average_length = 15.0 / 4;
+
+    const auto check_relevances = [&](const vector<Document>& documents, auto expected_score, double tolerance) {
+        CHECK(documents.size() == term_counts.size());
+        for (const Document& document : documents) {
+            const auto& [counts, length] = term_counts.at(document.id);
+            double expected = 0.0;
+            for (size_t i = 0; i < counts.size(); ++i) {
+                if (counts[i] > 0) {
+                    expected += expected_score(counts[i], length, document_freqs[i]);
+                }
+            }
+            CHECK(abs(document.relevance - expected) <= tolerance * expected);
+        }
+    };
+
+    // TF-IDF: доля слова в документе, умноженная на log(N / df)
+    const auto tf_idf = [&](int count, int length, int document_freq) {
+        return count * 1.0 / length * log(document_count / document_freq);
+    };
+    check_relevances(search_server.FindTopDocuments(query), tf_idf, 1e-12);
+    check_relevances(search_server.FindTopDocuments(execution::par, query), tf_idf, 1e-12);
+    check_relevances(search_server.FindTopDocuments(execution::seq, query, NoFilter{}, TfIdfScorer{}), tf_idf, 1e-12);
+
+    // BM25 с k1 = 1.2 и b = 0.75 считается во float
+    const auto bm25 = [&](int count, int length, int document_freq) {
+        const double word_weight = log(1.0 + (document_count - document_freq + 0.5) / (document_freq + 0.5));
+        return word_weight * count * 2.2 / (count + 1.2 * (0.25 + 0.75 * length / average_length));
+    };
+    check_relevances(search_server.FindTopDocuments(execution::seq, query, NoFilter{}, Bm25Scorer{}), bm25, 1e-5);
+    check_relevances(search_server.FindTopDocuments(execution::par, query, NoFilter{}, Bm25Scorer{}), bm25, 1e-5);
+
+    const vector<Document> ranked = search_server.FindTopDocuments(execution::seq, query, NoFilter{}, Bm25Scorer{});
+    CHECK(ranked.front().id == 2);
+}
+
+static void CheckWordFrequencies() {
+    SearchServer search_server("and"s);
+    search_server.AddDocument(1, "cat dog and cat bird"s, DocumentStatus::ACTUAL, { 1 });
+    const map<string_view, double> expected = { { "bird"sv, 0.25 }, { "cat"sv, 0.5 }, { "dog"sv, 0.25 } };
+    const vector<pair<string_view, double>> expected_entries(expected.begin(), expected.end());
+
+    // Слова идут по возрастанию, как в прежнем map<string_view, double>
+    const ForwardIndex::WordFrequencies word_freqs = search_server.GetWordFrequencies(1);
+    CHECK(word_freqs.size() == expected.size());
+    CHECK((map<string_view, double>(word_freqs.begin(), word_freqs.end()) == expected));
+    CHECK((vector<pair<string_view, double>>(word_freqs.begin(), word_freqs.end()) == expected_entries));
+    CHECK(search_server.CopyWordFrequencies(1) == expected);
+
+    CHECK(search_server.GetWordFrequencies(42).empty());
+    CHECK(search_server.CopyWordFrequencies(42).empty());
+
+    // Копия переживает удаления и повторные добавления, при которых прямой индекс уплотняется
+    const map<string_view, double> copy = search_server.CopyWordFrequencies(1);
+    for (int round = 0; round < 5; ++round) {
+        for (int id = 2; id < 20; ++id) {
+            search_server.AddDocument(id, "dog mouse "s + to_string(id % 3), DocumentStatus::ACTUAL, { 1 });
+        }
+        search_server.RemoveDocuments(vector<int>{ 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19 });
+        search_server.AddDocument(100 + round, "mouse mouse "s + to_string(round), DocumentStatus::ACTUAL, { 1 });
+        if (round % 2 == 0) {
+            search_server.RemoveDocument(100 + round);
+        }
+    }
+    CHECK(copy == expected);
+    CHECK(search_server.CopyWordFrequencies(1) == expected);
+    const ForwardIndex::WordFrequencies compacted = search_server.GetWordFrequencies(1);
+    CHECK((vector<pair<string_view, double>>(compacted.begin(), compacted.end()) == expected_entries));
+    const map<string_view, double> readded = search_server.CopyWordFrequencies(103);
+    CHECK((readded == map<string_view, double>{ { "3"sv, 1.0 / 3 }, { "mouse"sv, 2.0 / 3 } }));
+    CHECK(search_server.GetWordFrequencies(102).empty());
+    CHECK(search_server.GetMemoryReport().forward_index_entries == 3 + 2 * 2);
+}
+
+static void CheckCorpusIngestion() {
+    const string path = (filesystem::temp_directory_path() / "search_server_corpus_test.tsv"s).string();
+    {
+        ofstream out(path, ios::binary);
+        out << "1\tACTUAL\t1 2 3\twhite cat\r\n"s
+            << "x\tACTUAL\t1\tbad id\n"s
+            << "2\tUNKNOWN\t1\tbad status\n"s
+            << "\n"s
+            << "5\tACTUAL\t1 x\tbad rating\n"s
+            << "1\tBANNED\t5\tduplicate id\n"s
+            << "3\tBANNED\t -4  10 \tcurly dog\r\n"s
+            << "4\tACTUAL\t\tlast line"s;
+    }
+
+    // Фрагменты по несколько байт заканчиваются на границах строк, партии идут по две.
+    // Во втором проходе весь файл - один фрагмент, и рейтинги всех строк лежат в одном буфере
+    for (const size_t chunk_size : { size_t{ 7 }, CorpusIngestionOptions{}.chunk_size }) {
+        SearchServer search_server(""s);
+        CorpusIngestionOptions options;
+        options.chunk_size = chunk_size;
+        options.chunks_per_batch = 2;
+        const CorpusIngestionStats stats = IndexCorpusFile(search_server, path, options);
+
+        CHECK(stats.document_count == 3);
+        CHECK(stats.error_count == 4);
+        CHECK(search_server.GetDocumentText(1) == "white cat"s);
+        CHECK(search_server.GetDocumentText(3) == "curly dog"s);
+        CHECK(search_server.GetDocumentText(4) == "last line"s);
+
+        const vector<Document> cats = search_server.FindTopDocuments("cat"s);
+        CHECK(cats.size() == 1 && cats[0].id == 1 && cats[0].rating == 2);
+        const vector<Document> dogs = search_server.FindTopDocuments("dog"s, DocumentStatus::BANNED);
+        CHECK(dogs.size() == 1 && dogs[0].id == 3 && dogs[0].rating == 3);
+        const vector<Document> lines = search_server.FindTopDocuments("line"s);
+        CHECK(lines.size() == 1 && lines[0].id == 4 && lines[0].rating == 0);
+        CHECK(search_server.FindTopDocuments("duplicate"s, DocumentStatus::BANNED).empty());
+    }
+    filesystem::remove(path);
+}
+
+static void CheckRatingStats() {
+    const int max_int = numeric_limits<int>::max();
+    const int min_int = numeric_limits<int>::min();
+
+    const RatingStats overflowing = ComputeRatingStats({ max_int, max_int, max_int });
+    CHECK(overflowing.count == 3 && overflowing.mean == max_int);
+    CHECK(overflowing.min == max_int && overflowing.max == max_int);
+    CHECK(ComputeRatingStats({ min_int, min_int }).mean == min_int);
+
+    const RatingStats empty = ComputeRatingStats({});
+    CHECK(empty.count == 0 && empty.mean == 0 && empty.min == 0 && empty.max == 0);
+
+    // Среднее округляется к нулю, как при делении int
+    CHECK(ComputeRatingStats({ -1, -2 }).mean == -1);
+    CHECK(ComputeRatingStats({ -7, 0, 0 }).mean == -2);
+    CHECK(ComputeRatingStats({ 7, 0, 0 }).mean == 2);
+
+    // Больше одного блока дорожек и неполный хвост
+    vector<int> ratings;
+    for (int i = 0; i < 21; ++i) {
+        ratings.push_back((i * 37) % 23 - 11);
+    }
+    ratings[13] = -100;
+    ratings[20] = 100;
+    const RatingStats stats = ComputeRatingStats(ratings);
+    CHECK(stats.count == ratings.size());
+    CHECK(stats.min == -100 && stats.max == 100);
+    long long sum = 0;
+    for (const int rating : ratings) {
+        sum += rating;
+    }
+    CHECK(stats.mean == static_cast<int>(sum / static_cast<long long>(ratings.size())));
+
+    SearchServer search_server(""s);
+    search_server.AddDocument(1, "cat"s, DocumentStatus::ACTUAL, {});
+    search_server.AddDocument(2, "cat"s, DocumentStatus::ACTUAL, { 5 });
+    search_server.AddDocument(3, "cat"s, DocumentStatus::ACTUAL, { max_int, max_int, max_int });
+    const auto find_ids = [&search_server](size_t min_count) {
+        vector<int> ids;
+        for (const Document& document : search_server.FindTopDocuments(execution::seq, "cat"s,
+            RatingCountFilter{ min_count })) {
+            ids.push_back(document.id);
+        }
+        sort(ids.begin(), ids.end());
+        return ids;
+    };
+    CHECK((find_ids(0) == vector<int>{ 1, 2, 3 }));
+    CHECK((find_ids(1) == vector<int>{ 2, 3 }));
+    CHECK((find_ids(3) == vector<int>{ 3 }));
+    CHECK(find_ids(4).empty());
+    CHECK(search_server.FindTopDocuments("cat"s).front().rating == max_int);
+}
+
+static void CheckPagination() {
+    const auto to_vector = [](const auto& range) {
+        return vector<int>(range.begin(), range.end());
+    };
+
+    const vector<int> numbers = { 1, 2, 3, 4, 5, 6, 7 };
+    const auto vector_pages = Paginate(numbers, 3);
+    CHECK(vector_pages.size() == 3);
+    vector<vector<int>> pages;
+    for (const auto& page : vector_pages) {
+        pages.push_back(to_vector(page));
+    }
+    CHECK((pages == vector<vector<int>>{ { 1, 2, 3 }, { 4, 5, 6 }, { 7 } }));
+    CHECK((to_vector(vector_pages[1]) == vector<int>{ 4, 5, 6 }));
+    CHECK((to_vector(vector_pages[2]) == vector<int>{ 7 }));
+    CHECK(vector_pages[3].size() == 0);
+    CHECK(vector_pages[numeric_limits<size_t>::max()].size() == 0);
+
+    const list<int> list_numbers(numbers.begin(), numbers.end());
+    const auto list_pages = Paginate(list_numbers, 2);
+    CHECK(list_pages.size() == 4);
+    size_t page_count = 0;
+    for (const auto& page : list_pages) {
+        CHECK(page.size() == (page_count < 3 ? 2u : 1u));
+        ++page_count;
+    }
+    CHECK(page_count == 4);
+    CHECK((to_vector(list_pages[3]) == vector<int>{ 7 }));
+    CHECK(list_pages[4].size() == 0);
+    CHECK(list_pages[numeric_limits<size_t>::max()].size() == 0);
+
+    const vector<int> no_numbers;
+    const auto empty_pages = Paginate(no_numbers, 2);
+    CHECK(empty_pages.size() == 0 && empty_pages.begin() == empty_pages.end());
+
+    bool is_rejected = false;
+    try {
+        Paginate(numbers, 0);
+    }
+    catch (const invalid_argument&) {
+        is_rejected = true;
+    }
+    CHECK(is_rejected);
+
+    // Граница страницы не переполняет size_t при огромных номере и размере страницы
+    SearchServer search_server(""s);
+    for (int id = 0; id < 10; ++id) {
+        search_server.AddDocument(id, "cat"s, DocumentStatus::ACTUAL, { id });
+    }
+    const vector<Document> all = search_server.FindTopDocuments("cat"s, 0, numeric_limits<size_t>::max());
+    CHECK(all.size() == 10 && all.front().id == 9 && all.back().id == 0);
+    CHECK(search_server.FindTopDocuments("cat"s, numeric_limits<size_t>::max(), 2).empty());
+    CHECK(search_server.FindTopDocuments("cat"s, 1, numeric_limits<size_t>::max()).empty());
+    CHECK(search_server.FindTopDocuments("cat"s, 0, 0).empty());
+    const vector<Document> second_page = search_server.FindTopDocuments("cat"s, 1, 3);
+    CHECK(second_page.size() == 3 && second_page.front().id == 6 && second_page.back().id == 4);
+    const vector<Document> last_page = search_server.FindTopDocuments("cat"s, 3, 3);
+    CHECK(last_page.size() == 1 && last_page.front().id == 0);
+}
+
+void RunTests() {
+    CheckDocumentTexts();
+    CheckPhraseQueries();
+    CheckWildcardQueries();
+    CheckFuzzyQueries();
+    CheckDocumentFilters();
+    CheckRemoveDocuments();
+    CheckQueryPlans();
+    CheckQueryStrategies();
+    CheckScorers();
+    CheckWordFrequencies();
+    CheckCorpusIngestion();
+    CheckRatingStats();
+    CheckPagination();
+    cerr << "Tests passed"s << endl;
+}
@@ -0,0 +1,4 @@
+#pragma once
+
+// Самопроверки сервера, запускаются командой main --test
+void RunTests();